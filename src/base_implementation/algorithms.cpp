@@ -6,155 +6,257 @@
 #include <chrono>
 #include <sycl/sycl.hpp>
 #include "headers/utils.h"
+#include "headers/algorithms.h"
+#include "headers/engine.h"
+#include "headers/trace.h"
 #include <iostream>
 #include <iomanip> 
 
 using namespace sycl;
-constexpr std::size_t MaxIterations = 100;
 constexpr size_t TILE_SIZE = 16;
-constexpr size_t WorkGroupSize = 128;
-constexpr std::size_t MaxLabels = 16;
 
-void find_communities(HypergraphNotSparse& H) {
-    sycl::queue q(sycl::gpu_selector_v);
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static sycl::queue make_queue(bool profiling) {
+    if (profiling) {
+        return sycl::queue(preferred_device(), sycl::property_list{sycl::property::queue::in_order(), sycl::property::queue::enable_profiling()});
+    }
+    return sycl::queue(preferred_device(), sycl::property::queue::in_order());
+}
+
+// Counts one changed label of a traced run.
+static inline void count_change(uint32_t* counter) {
+    sycl::atomic_ref<uint32_t, sycl::memory_order::relaxed,
+                     sycl::memory_scope::device,
+                     sycl::access::address_space::global_space>
+        c(*counter);
+    c.fetch_add(1u);
+}
+
+// Commands of a traced run and its per-sweep changed counts (hyperedges, vertices), turned into a
+// PropagationTrace once the queue is idle. Does nothing when trace is null.
+struct TraceRecorder
+{
+    PropagationTrace* trace;
+    sycl::queue& q;
+    uint32_t* change_counts_dev = nullptr;
+    std::vector<std::pair<TraceEvent, sycl::event>> pending;
+
+    TraceRecorder(PropagationTrace* trace_, sycl::queue& q_) : trace(trace_), q(q_) {
+        if (trace == nullptr) return;
+        change_counts_dev = sycl::malloc_device<uint32_t>(2 * MaxIterations, q);
+        q.memset(change_counts_dev, 0, 2 * MaxIterations * sizeof(uint32_t)).wait();
+    }
+    ~TraceRecorder() {
+        if (change_counts_dev != nullptr) sycl::free(change_counts_dev, q);
+    }
+
+    uint32_t* hyperedge_counter(size_t it) const { return change_counts_dev == nullptr ? nullptr : change_counts_dev + 2 * it; }
+    uint32_t* vertex_counter(size_t it) const { return change_counts_dev == nullptr ? nullptr : change_counts_dev + 2 * it + 1; }
+
+    void record(const char* name, size_t iteration, const sycl::event& e) {
+        if (trace != nullptr) pending.push_back({{name, iteration, 0, 0}, e});
+    }
+
+    void finish(size_t sweeps) {
+        if (trace == nullptr) return;
+        q.wait();
+
+        uint64_t origin = std::numeric_limits<uint64_t>::max();
+        for (auto& [event, e] : pending) {
+            event.start_ns = e.get_profiling_info<sycl::info::event_profiling::command_start>();
+            event.end_ns = e.get_profiling_info<sycl::info::event_profiling::command_end>();
+            origin = std::min(origin, event.start_ns);
+        }
+        trace->events.clear();
+        for (auto& [event, e] : pending) {
+            event.start_ns -= origin;
+            event.end_ns -= origin;
+            trace->events.push_back(event);
+        }
+
+        std::vector<uint32_t> counts(2 * sweeps);
+        q.memcpy(counts.data(), change_counts_dev, counts.size() * sizeof(uint32_t)).wait();
+        trace->iterations.resize(sweeps);
+        for (size_t it = 0; it < sweeps; ++it) trace->iterations[it] = {counts[2 * it], counts[2 * it + 1]};
+    }
+};
+
+// Device-readable view of an incidence matrix. USM shared memory of q's context is read in place
+// (prefetched to the device); anything else is uploaded straight from its contiguous buffer into a
+// device allocation returned in owned, which the caller frees.
+template <typename Incidence>
+const Incidence* device_incidence(sycl::queue& q, const IncidenceMatrix<Incidence>& M, Incidence*& owned, TraceRecorder& recorder) {
+    owned = nullptr;
+    if (sycl::get_pointer_type(M.data(), q.get_context()) == sycl::usm::alloc::shared) {
+        recorder.record("h2d", 0, q.prefetch(M.data(), M.size() * sizeof(Incidence)));
+        return M.data();
+    }
+    owned = sycl::malloc_device<Incidence>(M.size(), q);
+    recorder.record("h2d", 0, q.memcpy(owned, M.data(), M.size() * sizeof(Incidence)));
+    return owned;
+}
+
+template <typename Counter, typename Label, typename Incidence>
+void find_communities(BasicHypergraphNotSparse<Label, Incidence>& H, PhaseTimings* timings, PropagationTrace* trace) {
+    sycl::queue q = make_queue(trace != nullptr);
+    TraceRecorder recorder(trace, q);
 
     const size_t N = H.num_vertices;
     const size_t E = H.num_hyperedges;
 
-    uint32_t* incidence_matrix_dev = sycl::malloc_device<uint32_t>(N * E, q);
-    uint32_t* vlabels_dev = sycl::malloc_device<uint32_t>(N, q);
-    uint32_t* helabels_dev = sycl::malloc_device<uint32_t>(E, q);
-    int* stop_flag_dev = sycl::malloc_device<int>(1, q);
-
-    constexpr uint32_t INVALID_LABEL = std::numeric_limits<uint32_t>::max();
+    Label* vlabels_dev = sycl::malloc_device<Label>(N, q);
+    Label* helabels_dev = sycl::malloc_device<Label>(E, q);
+    int* changed_dev = sycl::malloc_device<int>(MaxIterations, q);
 
-    std::vector<uint32_t> flat_incidence(N * E, 0);
-    for (size_t i = 0; i < N; ++i)
-        for (size_t j = 0; j < E; ++j)
-            flat_incidence[i * E + j] = H.incidence_matrix[i][j];
+    constexpr Label INVALID_LABEL = std::numeric_limits<Label>::max();
 
-    q.memcpy(incidence_matrix_dev, flat_incidence.data(), N * E * sizeof(uint32_t)).wait();
-    q.memcpy(vlabels_dev, H.vertex_labels.data(), N * sizeof(uint32_t)).wait();
-    q.memcpy(helabels_dev, H.hyperedge_labels.data(), E * sizeof(uint32_t)).wait();
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    Incidence* incidence_owned;
+    const Incidence* incidence_matrix_dev = device_incidence(q, H.incidence_matrix, incidence_owned, recorder);
+    recorder.record("h2d", 0, q.memcpy(vlabels_dev, H.vertex_labels.data(), N * sizeof(Label)));
+    recorder.record("h2d", 0, q.memcpy(helabels_dev, H.hyperedge_labels.data(), E * sizeof(Label)));
+    q.wait();
+    double upload_ms = elapsed_ms(phase_start);
 
-    std::vector<int> stop_flag_host(1);
+    std::vector<int> changed_host(MaxIterations);
+    q.memset(changed_dev, 0, MaxIterations * sizeof(int)).wait();
 
-    size_t iter = 0;
+    size_t iter = 0, queued = 0;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    while (iter < MaxIterations) {
-        stop_flag_host[0] = 0;
-        q.memcpy(stop_flag_dev, stop_flag_host.data(), sizeof(int)).wait();
-
-        q.submit([&](sycl::handler& h) {
-            sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
-            h.parallel_for(
-                sycl::nd_range<1>(((E + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
-                [=](sycl::nd_item<1> idx) {
-                    size_t e = idx.get_global_id(0);
-                    if (e >= E) return;
-
-                    auto label_counts = label_counts_acc[idx.get_local_id(0)];
-                    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
-
-                    for (size_t v = 0; v < N; ++v) {
-                        if (incidence_matrix_dev[v * E + e] == 1) {
-                            uint32_t lbl = vlabels_dev[v];
-                            if (lbl < MaxLabels && lbl != INVALID_LABEL) {
-                                label_counts[lbl]++;
+    bool converged = false;
+    while (iter < MaxIterations && !converged) {
+        // Queue a batch of iterations on the in-order queue; iteration i flags changed_dev[i] if any vertex changed.
+        size_t batch_end = std::min(iter + ConvergenceCheckInterval, MaxIterations);
+        for (size_t it = iter; it < batch_end; ++it) {
+            int* changed_flag = changed_dev + it;
+            uint32_t* changed_hyperedges = recorder.hyperedge_counter(it);
+            uint32_t* changed_vertices = recorder.vertex_counter(it);
+
+            recorder.record("hyperedge_phase", it, q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<Counter, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((E + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t e = idx.get_global_id(0);
+                        if (e >= E) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        for (size_t v = 0; v < N; ++v) {
+                            if (incidence_matrix_dev[v * E + e] == 1) {
+                                Label lbl = vlabels_dev[v];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
                             }
                         }
-                    }
 
-                    uint32_t max_count = 0, best_label = INVALID_LABEL;
-                    for (size_t i = 0; i < MaxLabels; ++i) {
-                        if (label_counts[i] > max_count) {
-                            max_count = label_counts[i];
-                            best_label = i;
+                        Counter max_count = 0;
+                        Label best_label = INVALID_LABEL;
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = static_cast<Label>(i);
+                            }
                         }
-                    }
-
-                    if (best_label != INVALID_LABEL) {
-                        helabels_dev[e] = best_label;
-                    }
-                });
-        }).wait();
-
-        q.submit([&](sycl::handler& h) {
-            sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
-            h.parallel_for(
-                sycl::nd_range<1>(((N + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
-                [=](sycl::nd_item<1> idx) {
-                    size_t v = idx.get_global_id(0);
-                    if (v >= N) return;
-
-                    auto label_counts = label_counts_acc[idx.get_local_id(0)];
-                    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
-
-                    for (size_t e = 0; e < E; ++e) {
-                        if (incidence_matrix_dev[v * E + e] == 1) {
-                            uint32_t lbl = helabels_dev[e];
-                            if (lbl < MaxLabels && lbl != INVALID_LABEL) {
-                                label_counts[lbl]++;
+
+                        if (best_label != INVALID_LABEL) {
+                            if (changed_hyperedges != nullptr && helabels_dev[e] != best_label) count_change(changed_hyperedges);
+                            helabels_dev[e] = best_label;
+                        }
+                    });
+            }));
+
+            recorder.record("vertex_phase", it, q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<Counter, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((N + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t v = idx.get_global_id(0);
+                        if (v >= N) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        for (size_t e = 0; e < E; ++e) {
+                            if (incidence_matrix_dev[v * E + e] == 1) {
+                                Label lbl = helabels_dev[e];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
                             }
                         }
-                    }
-
-                    uint32_t max_count = 0;
-                    uint32_t best_label = vlabels_dev[v];
-                    for (size_t i = 0; i < MaxLabels; ++i) {
-                        if (label_counts[i] > max_count) {
-                            max_count = label_counts[i];
-                            best_label = i;
+
+                        Counter max_count = 0;
+                        Label best_label = vlabels_dev[v];
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = static_cast<Label>(i);
+                            }
                         }
-                    }
-
-                    if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
-                        vlabels_dev[v] = best_label;
-                        sycl::atomic_ref<int, sycl::memory_order::relaxed,
-                                         sycl::memory_scope::device,
-                                         sycl::access::address_space::global_space>
-                            af(stop_flag_dev[0]);
-                        af.store(1);
-                    }
-                });
-        }).wait();
-
-        q.memcpy(stop_flag_host.data(), stop_flag_dev, sizeof(int)).wait();
-        if (stop_flag_host[0] == 0) break;
-        iter++;
+
+                        if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
+                            vlabels_dev[v] = best_label;
+                            sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                             sycl::memory_scope::device,
+                                             sycl::access::address_space::global_space>
+                                af(*changed_flag);
+                            af.store(1);
+                            if (changed_vertices != nullptr) count_change(changed_vertices);
+                        }
+                    });
+            }));
+        }
+        queued = batch_end;
+
+        // The first unchanged iteration is the convergence point; the ones queued after it are no-ops.
+        q.memcpy(changed_host.data() + iter, changed_dev + iter, (batch_end - iter) * sizeof(int)).wait();
+        for (; iter < batch_end && !converged; ++iter) {
+            converged = changed_host[iter] == 0;
+        }
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     double total_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-    std::cout << "Total time baseline (ms): " << total_time_ms << std::endl;
+    if (timings == nullptr) std::cout << "Total time baseline (ms): " << total_time_ms << std::endl;
 
     assert(H.vertex_labels.size() == N && "vertex_labels size mismatch");
     assert(H.hyperedge_labels.size() == E && "hyperedge_labels size mismatch");
 
-    q.memcpy(H.vertex_labels.data(), vlabels_dev, N * sizeof(uint32_t)).wait();
-    q.memcpy(H.hyperedge_labels.data(), helabels_dev, E * sizeof(uint32_t)).wait();
+    phase_start = std::chrono::high_resolution_clock::now();
+    recorder.record("d2h", 0, q.memcpy(H.vertex_labels.data(), vlabels_dev, N * sizeof(Label)));
+    recorder.record("d2h", 0, q.memcpy(H.hyperedge_labels.data(), helabels_dev, E * sizeof(Label)));
+    q.wait();
+    if (timings != nullptr) *timings = {0, upload_ms, 0, total_time_ms, elapsed_ms(phase_start), iter};
+    recorder.finish(queued);
 
-    sycl::free(incidence_matrix_dev, q);
+    sycl::free(incidence_owned, q);
     sycl::free(vlabels_dev, q);
     sycl::free(helabels_dev, q);
-    sycl::free(stop_flag_dev, q);
+    sycl::free(changed_dev, q);
 }
 
-bool checkTransposeCorrectness(uint32_t* originalDev,
-                               uint32_t* transposedDev,
+template <typename Incidence>
+bool checkTransposeCorrectness(Incidence* originalDev,
+                               Incidence* transposedDev,
                                sycl::queue& q,
                                size_t N, size_t E) {
-    std::vector<uint32_t> originalHost(N * E);
-    std::vector<uint32_t> transposedHost(E * N);
+    std::vector<Incidence> originalHost(N * E);
+    std::vector<Incidence> transposedHost(E * N);
 
-    q.memcpy(originalHost.data(), originalDev, N * E * sizeof(uint32_t)).wait();
-    q.memcpy(transposedHost.data(), transposedDev, E * N * sizeof(uint32_t)).wait();
+    q.memcpy(originalHost.data(), originalDev, N * E * sizeof(Incidence)).wait();
+    q.memcpy(transposedHost.data(), transposedDev, E * N * sizeof(Incidence)).wait();
 
     for (size_t v = 0; v < N; ++v) {
         for (size_t e = 0; e < E; ++e) {
-            uint32_t orig = originalHost[v * E + e];
-            uint32_t transp = transposedHost[e * N + v];
+            Incidence orig = originalHost[v * E + e];
+            Incidence transp = transposedHost[e * N + v];
             if (orig != transp) {
                 std::cerr << "Mismatch at original[" << v << "][" << e << "] = "
                           << (int)orig << " vs transpose[" << e << "][" << v << "] = "
@@ -168,20 +270,14 @@ bool checkTransposeCorrectness(uint32_t* originalDev,
     return true;
 }
 
-void transpose_incidence_matrix(sycl::queue& q, const std::vector<std::vector<uint32_t>>& incidence_matrix, uint32_t* incidence_matrix_T, uint32_t* incidence_matrix_dev, size_t N, size_t E) {
-    std::vector<uint32_t> incidence_flat(N * E);
-
-    for (size_t v = 0; v < N; ++v) {
-        for (size_t e = 0; e < E; ++e) {
-            incidence_flat[v * E + e] = incidence_matrix[v][e];
-        }
-    }
-    q.memcpy(incidence_matrix_dev, incidence_flat.data(), N * E * sizeof(uint32_t)).wait();
-
+// Transposes the uploaded N x E matrix into incidence_matrix_T; returns the kernel time in ms.
+template <typename Incidence>
+double transpose_incidence_matrix(sycl::queue& q, Incidence* incidence_matrix_T, const Incidence* incidence_matrix_dev, size_t N, size_t E,
+                                  TraceRecorder& recorder) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    q.submit([&](sycl::handler& h) {
-        sycl::local_accessor<uint32_t, 2> tile(sycl::range<2>(TILE_SIZE, TILE_SIZE), h);
+    sycl::event transposed = q.submit([&](sycl::handler& h) {
+        sycl::local_accessor<Incidence, 2> tile(sycl::range<2>(TILE_SIZE, TILE_SIZE), h);
 
         h.parallel_for(sycl::nd_range<2>(
             sycl::range<2>((E + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE,
@@ -209,138 +305,460 @@ void transpose_incidence_matrix(sycl::queue& q, const std::vector<std::vector<ui
                     incidence_matrix_T[transposed_e * N + transposed_v] = tile[local_v][local_e];
                 }
             });
+    });
+    transposed.wait();
+    recorder.record("transpose", 0, transposed);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end_time - start_time).count();
+}
+
+template <typename Counter, typename Label, typename Incidence>
+void find_communities_transpose(BasicHypergraphNotSparse<Label, Incidence>& H, PhaseTimings* timings, PropagationTrace* trace) {
+    sycl::queue q = make_queue(trace != nullptr);
+    TraceRecorder recorder(trace, q);
+
+    const size_t N = H.num_vertices;
+    const size_t E = H.num_hyperedges;
+
+    Incidence* incidence_matrix_T_dev = sycl::malloc_device<Incidence>(E * N, q);
+    Label* vlabels_dev = sycl::malloc_device<Label>(N, q);
+    Label* helabels_dev = sycl::malloc_device<Label>(E, q);
+    int* changed_dev = sycl::malloc_device<int>(MaxIterations, q);
+
+    constexpr Label INVALID_LABEL = std::numeric_limits<Label>::max();
+
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    Incidence* incidence_owned;
+    const Incidence* incidence_matrix_dev = device_incidence(q, H.incidence_matrix, incidence_owned, recorder);
+    recorder.record("h2d", 0, q.memcpy(vlabels_dev, H.vertex_labels.data(), N * sizeof(Label)));
+    recorder.record("h2d", 0, q.memcpy(helabels_dev, H.hyperedge_labels.data(), E * sizeof(Label)));
+    q.wait();
+    double upload_ms = elapsed_ms(phase_start);
+
+    std::vector<int> changed_host(MaxIterations);
+    q.memset(changed_dev, 0, MaxIterations * sizeof(int)).wait();
+
+    double transpose_ms = transpose_incidence_matrix(q, incidence_matrix_T_dev, incidence_matrix_dev, N, E, recorder);
+
+    size_t iter = 0, queued = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    bool converged = false;
+    while (iter < MaxIterations && !converged) {
+        // Queue a batch of iterations on the in-order queue; iteration i flags changed_dev[i] if any vertex changed.
+        size_t batch_end = std::min(iter + ConvergenceCheckInterval, MaxIterations);
+        for (size_t it = iter; it < batch_end; ++it) {
+            int* changed_flag = changed_dev + it;
+            uint32_t* changed_hyperedges = recorder.hyperedge_counter(it);
+            uint32_t* changed_vertices = recorder.vertex_counter(it);
+
+            recorder.record("hyperedge_phase", it, q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<Counter, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((E + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t e = idx.get_global_id(0);
+                        if (e >= E) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        for (size_t v = 0; v < N; ++v) {
+                            if (incidence_matrix_dev[v * E + e] == 1) {
+                                Label lbl = vlabels_dev[v];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
+                            }
+                        }
+
+                        Counter max_count = 0;
+                        Label best_label = INVALID_LABEL;
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = static_cast<Label>(i);
+                            }
+                        }
+
+                        if (best_label != INVALID_LABEL) {
+                            if (changed_hyperedges != nullptr && helabels_dev[e] != best_label) count_change(changed_hyperedges);
+                            helabels_dev[e] = best_label;
+                        }
+                    });
+            }));
+
+            recorder.record("vertex_phase", it, q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<Counter, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((N + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t v = idx.get_global_id(0);
+                        if (v >= N) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        for (size_t e = 0; e < E; ++e) {
+                            if (incidence_matrix_T_dev[e * N + v] == 1) {
+                                Label lbl = helabels_dev[e];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
+                            }
+                        }
+
+                        Counter max_count = 0;
+                        Label best_label = vlabels_dev[v];
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = static_cast<Label>(i);
+                            }
+                        }
+
+                        if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
+                            vlabels_dev[v] = best_label;
+                            sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                             sycl::memory_scope::device,
+                                             sycl::access::address_space::global_space>
+                                af(*changed_flag);
+                            af.store(1);
+                            if (changed_vertices != nullptr) count_change(changed_vertices);
+                        }
+                    });
+            }));
+        }
+        queued = batch_end;
+
+        // The first unchanged iteration is the convergence point; the ones queued after it are no-ops.
+        q.memcpy(changed_host.data() + iter, changed_dev + iter, (batch_end - iter) * sizeof(int)).wait();
+        for (; iter < batch_end && !converged; ++iter) {
+            converged = changed_host[iter] == 0;
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double total_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    if (timings == nullptr) std::cout << "Total time transpose (ms): " << total_time_ms << std::endl;
+
+    assert(H.vertex_labels.size() == N && "vertex_labels size mismatch");
+    assert(H.hyperedge_labels.size() == E && "hyperedge_labels size mismatch");
+
+    phase_start = std::chrono::high_resolution_clock::now();
+    recorder.record("d2h", 0, q.memcpy(H.vertex_labels.data(), vlabels_dev, N * sizeof(Label)));
+    recorder.record("d2h", 0, q.memcpy(H.hyperedge_labels.data(), helabels_dev, E * sizeof(Label)));
+    q.wait();
+    if (timings != nullptr) *timings = {0, upload_ms, transpose_ms, total_time_ms, elapsed_ms(phase_start), iter};
+    recorder.finish(queued);
+
+    sycl::free(incidence_owned, q);
+    sycl::free(incidence_matrix_T_dev, q);
+    sycl::free(vlabels_dev, q);
+    sycl::free(helabels_dev, q);
+    sycl::free(changed_dev, q);
+}
+
+#define INSTANTIATE_FIND_COMMUNITIES(Counter, Label, Incidence) \
+    template void find_communities<Counter>(BasicHypergraphNotSparse<Label, Incidence>&, PhaseTimings*, PropagationTrace*); \
+    template void find_communities_transpose<Counter>(BasicHypergraphNotSparse<Label, Incidence>&, PhaseTimings*, PropagationTrace*);
+#define INSTANTIATE_FIND_COMMUNITIES_INCIDENCE(Counter, Label) \
+    INSTANTIATE_FIND_COMMUNITIES(Counter, Label, uint8_t) \
+    INSTANTIATE_FIND_COMMUNITIES(Counter, Label, uint16_t) \
+    INSTANTIATE_FIND_COMMUNITIES(Counter, Label, uint32_t)
+#define INSTANTIATE_FIND_COMMUNITIES_LABEL(Counter) \
+    INSTANTIATE_FIND_COMMUNITIES_INCIDENCE(Counter, uint8_t) \
+    INSTANTIATE_FIND_COMMUNITIES_INCIDENCE(Counter, uint16_t) \
+    INSTANTIATE_FIND_COMMUNITIES_INCIDENCE(Counter, uint32_t)
+
+INSTANTIATE_FIND_COMMUNITIES_LABEL(uint8_t)
+INSTANTIATE_FIND_COMMUNITIES_LABEL(uint16_t)
+INSTANTIATE_FIND_COMMUNITIES_LABEL(uint32_t)
+
+IncidenceAllocation usm_incidence_allocation(const sycl::queue& q, sycl::usm::alloc kind) {
+    return {[q, kind](size_t bytes) { return sycl::malloc(bytes, q, kind); },
+            [q](void* p) { sycl::free(p, q); }};
+}
+
+DenseTypeSelection select_dense_types(const HypergraphNotSparse& H) {
+    constexpr uint32_t INVALID_LABEL = std::numeric_limits<uint32_t>::max();
+
+    uint32_t max_label = 0;
+    for (uint32_t lbl : H.vertex_labels) {
+        if (lbl != INVALID_LABEL) max_label = std::max(max_label, lbl);
+    }
+    for (uint32_t lbl : H.hyperedge_labels) {
+        if (lbl != INVALID_LABEL) max_label = std::max(max_label, lbl);
+    }
+
+    size_t max_degree = 0;
+    std::vector<size_t> hyperedge_degree(H.num_hyperedges, 0);
+    for (size_t v = 0; v < H.num_vertices; ++v) {
+        size_t degree = 0;
+        for (size_t e = 0; e < H.num_hyperedges; ++e) {
+            if (H.incidence_matrix[v][e] == 1) {
+                degree++;
+                hyperedge_degree[e]++;
+            }
+        }
+        max_degree = std::max(max_degree, degree);
+    }
+    for (size_t degree : hyperedge_degree) max_degree = std::max(max_degree, degree);
+
+    // The all-ones label is the unlabeled marker, so a label type must hold max_label strictly below it.
+    DenseTypeSelection types;
+    types.label_bytes = max_label < std::numeric_limits<uint8_t>::max() ? 1 : max_label < std::numeric_limits<uint16_t>::max() ? 2 : 4;
+    types.counter_bytes = max_degree <= std::numeric_limits<uint8_t>::max() ? 1 : max_degree <= std::numeric_limits<uint16_t>::max() ? 2 : 4;
+    types.incidence_bytes = 1;
+    return types;
+}
+
+// The narrowing and widening copies count as flatten time.
+template <typename Counter, typename Label>
+void find_communities_as(HypergraphNotSparse& H, bool transpose, PhaseTimings* timings) {
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    BasicHypergraphNotSparse<Label, uint8_t> narrow = convert_hypergraph<Label, uint8_t>(H);
+    double convert_ms = elapsed_ms(phase_start);
+
+    if (transpose) {
+        find_communities_transpose<Counter>(narrow, timings);
+    } else {
+        find_communities<Counter>(narrow, timings);
+    }
+
+    phase_start = std::chrono::high_resolution_clock::now();
+    H.vertex_labels = convert_labels<uint32_t>(narrow.vertex_labels);
+    H.hyperedge_labels = convert_labels<uint32_t>(narrow.hyperedge_labels);
+    if (timings != nullptr) timings->flatten_ms += convert_ms + elapsed_ms(phase_start);
+}
+
+template <typename Label>
+void find_communities_with_label(HypergraphNotSparse& H, size_t counter_bytes, bool transpose, PhaseTimings* timings) {
+    if (counter_bytes == 1) {
+        find_communities_as<uint8_t, Label>(H, transpose, timings);
+    } else if (counter_bytes == 2) {
+        find_communities_as<uint16_t, Label>(H, transpose, timings);
+    } else {
+        find_communities_as<uint32_t, Label>(H, transpose, timings);
+    }
+}
+
+void find_communities_dispatch(HypergraphNotSparse& H, bool transpose, PhaseTimings* timings) {
+    DenseTypeSelection types = select_dense_types(H);
+    if (timings == nullptr) {
+        std::cout << "Selected types: label uint" << 8 * types.label_bytes << "_t, counter uint" << 8 * types.counter_bytes
+                  << "_t, incidence uint" << 8 * types.incidence_bytes << "_t" << std::endl;
+    }
+
+    if (types.label_bytes == 1) {
+        find_communities_with_label<uint8_t>(H, types.counter_bytes, transpose, timings);
+    } else if (types.label_bytes == 2) {
+        find_communities_with_label<uint16_t>(H, types.counter_bytes, transpose, timings);
+    } else {
+        find_communities_with_label<uint32_t>(H, types.counter_bytes, transpose, timings);
+    }
+}
+
+// Engine setup counts as upload; the label upload and download around the iterations count as download.
+void find_communities_sparse(HypergraphSparse& H, PhaseTimings* timings) {
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    LabelPropagationEngine engine(H);
+    double upload_ms = elapsed_ms(phase_start);
+
+    phase_start = std::chrono::high_resolution_clock::now();
+    LabelPropagationResult result = engine.run(H.vertex_labels);
+    double run_ms = elapsed_ms(phase_start);
+
+    if (timings == nullptr) {
+        std::cout << "Total time sparse (ms): " << result.time_ms << std::endl;
+    } else {
+        *timings = {0, upload_ms, 0, result.time_ms, run_ms - result.time_ms, result.iterations};
+    }
+
+    H.vertex_labels = std::move(result.vertex_labels);
+    H.hyperedge_labels = std::move(result.hyperedge_labels);
+}
+
+// Transposes the N x E vertex bitset into an E x N hyperedge bitset, one 64x64 bit tile per work-group;
+// returns the kernel time in ms.
+double transpose_incidence_bitset(sycl::queue& q, const uint64_t* incidence_bits_dev, uint64_t* incidence_bits_T_dev,
+                                size_t N, size_t E, size_t words_per_row, size_t words_per_row_T) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    q.submit([&](sycl::handler& h) {
+        sycl::local_accessor<uint64_t, 1> tile(sycl::range<1>(BitsetWordBits), h);
+
+        h.parallel_for(sycl::nd_range<2>(
+            sycl::range<2>(words_per_row_T, words_per_row * BitsetWordBits),
+            sycl::range<2>(1, BitsetWordBits)),
+            [=](sycl::nd_item<2> item) {
+                size_t tile_v = item.get_group(0);
+                size_t tile_e = item.get_group(1);
+                size_t lane = item.get_local_id(1);
+
+                size_t v = tile_v * BitsetWordBits + lane;
+                tile[lane] = v < N ? incidence_bits_dev[v * words_per_row + tile_e] : 0;
+
+                item.barrier(sycl::access::fence_space::local_space);
+
+                size_t e = tile_e * BitsetWordBits + lane;
+                if (e >= E) return;
+
+                uint64_t word = 0;
+                for (size_t i = 0; i < BitsetWordBits; ++i) {
+                    word |= ((tile[i] >> lane) & 1) << i;
+                }
+                incidence_bits_T_dev[e * words_per_row_T + tile_v] = word;
+            });
     }).wait();
 
     auto end_time = std::chrono::high_resolution_clock::now();
-    double duration_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-    // std::cout << "Tempo per trasporre la matrice (ms): " << duration_ms << std::endl;
+    return std::chrono::duration<double, std::milli>(end_time - start_time).count();
 }
 
-void find_communities_transpose(HypergraphNotSparse& H) {
-    sycl::queue q(sycl::gpu_selector_v);
+void find_communities_bitset(HypergraphBitset& H, PhaseTimings* timings) {
+    sycl::queue q(preferred_device(), sycl::property::queue::in_order());
 
     const size_t N = H.num_vertices;
     const size_t E = H.num_hyperedges;
+    const size_t EWords = H.words_per_row;
+    const size_t VWords = bitset_words_per_row(N);
 
-    uint32_t* incidence_matrix_dev = sycl::malloc_device<uint32_t>(N * E, q);
-    uint32_t* incidence_matrix_T_dev = sycl::malloc_device<uint32_t>(E * N, q);
+    uint64_t* incidence_bits_dev = sycl::malloc_device<uint64_t>(N * EWords, q);
+    uint64_t* incidence_bits_T_dev = sycl::malloc_device<uint64_t>(E * VWords, q);
     uint32_t* vlabels_dev = sycl::malloc_device<uint32_t>(N, q);
     uint32_t* helabels_dev = sycl::malloc_device<uint32_t>(E, q);
-    int* stop_flag_dev = sycl::malloc_device<int>(1, q);
+    int* changed_dev = sycl::malloc_device<int>(MaxIterations, q);
 
     constexpr uint32_t INVALID_LABEL = std::numeric_limits<uint32_t>::max();
 
-    std::vector<uint32_t> flat_incidence(N * E, 0);
-    for (size_t i = 0; i < N; ++i)
-        for (size_t j = 0; j < E; ++j)
-            flat_incidence[i * E + j] = H.incidence_matrix[i][j];
-
-    q.memcpy(incidence_matrix_dev, flat_incidence.data(), N * E * sizeof(uint32_t)).wait();
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    q.memcpy(incidence_bits_dev, H.incidence_bits.data(), N * EWords * sizeof(uint64_t)).wait();
     q.memcpy(vlabels_dev, H.vertex_labels.data(), N * sizeof(uint32_t)).wait();
     q.memcpy(helabels_dev, H.hyperedge_labels.data(), E * sizeof(uint32_t)).wait();
+    double upload_ms = elapsed_ms(phase_start);
 
-    std::vector<int> stop_flag_host(1);
+    std::vector<int> changed_host(MaxIterations);
+    q.memset(changed_dev, 0, MaxIterations * sizeof(int)).wait();
 
-    transpose_incidence_matrix(q, H.incidence_matrix, incidence_matrix_T_dev, incidence_matrix_dev, N, E);
+    double transpose_ms = transpose_incidence_bitset(q, incidence_bits_dev, incidence_bits_T_dev, N, E, EWords, VWords);
 
     size_t iter = 0;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    while (iter < MaxIterations) {
-        stop_flag_host[0] = 0;
-        q.memcpy(stop_flag_dev, stop_flag_host.data(), sizeof(int)).wait();
-
-        q.submit([&](sycl::handler& h) {
-            sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
-            h.parallel_for(
-                sycl::nd_range<1>(((E + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
-                [=](sycl::nd_item<1> idx) {
-                    size_t e = idx.get_global_id(0);
-                    if (e >= E) return;
-
-                    auto label_counts = label_counts_acc[idx.get_local_id(0)];
-                    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
-
-                    for (size_t v = 0; v < N; ++v) {
-                        if (incidence_matrix_dev[v * E + e] == 1) {
-                            uint32_t lbl = vlabels_dev[v];
-                            if (lbl < MaxLabels && lbl != INVALID_LABEL) {
-                                label_counts[lbl]++;
+    bool converged = false;
+    while (iter < MaxIterations && !converged) {
+        // Queue a batch of iterations on the in-order queue; iteration i flags changed_dev[i] if any vertex changed.
+        size_t batch_end = std::min(iter + ConvergenceCheckInterval, MaxIterations);
+        for (size_t it = iter; it < batch_end; ++it) {
+            int* changed_flag = changed_dev + it;
+
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((E + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t e = idx.get_global_id(0);
+                        if (e >= E) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        const uint64_t* row = incidence_bits_T_dev + e * VWords;
+                        for (size_t w = 0; w < VWords; ++w) {
+                            uint64_t bits = row[w];
+                            while (bits != 0) {
+                                size_t v = w * BitsetWordBits + sycl::ctz(bits);
+                                bits &= bits - 1;
+                                uint32_t lbl = vlabels_dev[v];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
                             }
                         }
-                    }
 
-                    uint32_t max_count = 0, best_label = INVALID_LABEL;
-                    for (size_t i = 0; i < MaxLabels; ++i) {
-                        if (label_counts[i] > max_count) {
-                            max_count = label_counts[i];
-                            best_label = i;
+                        uint32_t max_count = 0, best_label = INVALID_LABEL;
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = i;
+                            }
+                        }
+
+                        if (best_label != INVALID_LABEL) {
+                            helabels_dev[e] = best_label;
+                        }
+                    });
+            });
+
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+                h.parallel_for(
+                    sycl::nd_range<1>(((N + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
+                    [=](sycl::nd_item<1> idx) {
+                        size_t v = idx.get_global_id(0);
+                        if (v >= N) return;
+
+                        auto label_counts = label_counts_acc[idx.get_local_id(0)];
+                        for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+                        const uint64_t* row = incidence_bits_dev + v * EWords;
+                        for (size_t w = 0; w < EWords; ++w) {
+                            uint64_t bits = row[w];
+                            while (bits != 0) {
+                                size_t e = w * BitsetWordBits + sycl::ctz(bits);
+                                bits &= bits - 1;
+                                uint32_t lbl = helabels_dev[e];
+                                if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+                                    label_counts[lbl]++;
+                                }
+                            }
                         }
-                    }
-
-                    if (best_label != INVALID_LABEL) {
-                        helabels_dev[e] = best_label;
-                    }
-                });
-        }).wait();
-
-        q.submit([&](sycl::handler& h) {
-            sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
-            h.parallel_for(
-                sycl::nd_range<1>(((N + WorkGroupSize - 1) / WorkGroupSize) * WorkGroupSize, WorkGroupSize),
-                [=](sycl::nd_item<1> idx) {
-                    size_t v = idx.get_global_id(0);
-                    if (v >= N) return;
-
-                    auto label_counts = label_counts_acc[idx.get_local_id(0)];
-                    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
-
-                    for (size_t e = 0; e < E; ++e) {
-                        if (incidence_matrix_T_dev[e * N + v] == 1) {
-                            uint32_t lbl = helabels_dev[e];
-                            if (lbl < MaxLabels && lbl != INVALID_LABEL) {
-                                label_counts[lbl]++;
+
+                        uint32_t max_count = 0;
+                        uint32_t best_label = vlabels_dev[v];
+                        for (size_t i = 0; i < MaxLabels; ++i) {
+                            if (label_counts[i] > max_count) {
+                                max_count = label_counts[i];
+                                best_label = i;
                             }
                         }
-                    }
-
-                    uint32_t max_count = 0;
-                    uint32_t best_label = vlabels_dev[v];
-                    for (size_t i = 0; i < MaxLabels; ++i) {
-                        if (label_counts[i] > max_count) {
-                            max_count = label_counts[i];
-                            best_label = i;
+
+                        if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
+                            vlabels_dev[v] = best_label;
+                            sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                             sycl::memory_scope::device,
+                                             sycl::access::address_space::global_space>
+                                af(*changed_flag);
+                            af.store(1);
                         }
-                    }
-
-                    if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
-                        vlabels_dev[v] = best_label;
-                        sycl::atomic_ref<int, sycl::memory_order::relaxed,
-                                         sycl::memory_scope::device,
-                                         sycl::access::address_space::global_space>
-                            af(stop_flag_dev[0]);
-                        af.store(1);
-                    }
-                });
-        }).wait();
-
-        q.memcpy(stop_flag_host.data(), stop_flag_dev, sizeof(int)).wait();
-        if (stop_flag_host[0] == 0) break;
-        iter++;
+                    });
+            });
+        }
+
+        // The first unchanged iteration is the convergence point; the ones queued after it are no-ops.
+        q.memcpy(changed_host.data() + iter, changed_dev + iter, (batch_end - iter) * sizeof(int)).wait();
+        for (; iter < batch_end && !converged; ++iter) {
+            converged = changed_host[iter] == 0;
+        }
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     double total_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-    std::cout << "Total time transpose (ms): " << total_time_ms << std::endl;
+    if (timings == nullptr) std::cout << "Total time bitset (ms): " << total_time_ms << std::endl;
 
     assert(H.vertex_labels.size() == N && "vertex_labels size mismatch");
     assert(H.hyperedge_labels.size() == E && "hyperedge_labels size mismatch");
 
+    phase_start = std::chrono::high_resolution_clock::now();
     q.memcpy(H.vertex_labels.data(), vlabels_dev, N * sizeof(uint32_t)).wait();
     q.memcpy(H.hyperedge_labels.data(), helabels_dev, E * sizeof(uint32_t)).wait();
+    if (timings != nullptr) *timings = {0, upload_ms, transpose_ms, total_time_ms, elapsed_ms(phase_start), iter};
 
-    sycl::free(incidence_matrix_dev, q);
+    sycl::free(incidence_bits_dev, q);
+    sycl::free(incidence_bits_T_dev, q);
     sycl::free(vlabels_dev, q);
     sycl::free(helabels_dev, q);
-    sycl::free(stop_flag_dev, q);
-}
\ No newline at end of file
+    sycl::free(changed_dev, q);
+}
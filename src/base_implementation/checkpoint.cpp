@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "headers/checkpoint.h"
+
+namespace {
+
+void write_checkpoint(const std::string& path, std::uint64_t iteration, bool converged, const std::uint32_t* vertex_labels,
+                      std::size_t N, const std::uint32_t* hyperedge_labels, std::size_t E) {
+    CheckpointFileHeader header = {};
+    std::memcpy(header.magic, CheckpointFileMagic, sizeof(CheckpointFileMagic));
+    header.version = CheckpointFileVersion;
+    header.converged = converged ? 1 : 0;
+    header.num_vertices = N;
+    header.num_hyperedges = E;
+    header.iteration = iteration;
+
+    const std::string partial = path + ".partial";
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("cannot create " + partial);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertex_labels), static_cast<std::streamsize>(N * sizeof(std::uint32_t)));
+        file.write(reinterpret_cast<const char*>(hyperedge_labels), static_cast<std::streamsize>(E * sizeof(std::uint32_t)));
+        file.close();
+        if (!file) throw std::runtime_error("error writing " + partial);
+    }
+    std::filesystem::rename(partial, path);
+}
+
+}
+
+void save_checkpoint(const LabelCheckpoint& checkpoint, const std::string& path) {
+    write_checkpoint(path, checkpoint.iteration, checkpoint.converged, checkpoint.vertex_labels.data(), checkpoint.vertex_labels.size(),
+                     checkpoint.hyperedge_labels.data(), checkpoint.hyperedge_labels.size());
+}
+
+LabelCheckpoint load_checkpoint(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("cannot open " + path);
+
+    CheckpointFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CheckpointFileMagic, sizeof(CheckpointFileMagic)) != 0) {
+        throw std::runtime_error(path + " is not a checkpoint file");
+    }
+    if (header.version != CheckpointFileVersion) {
+        throw std::runtime_error(path + ": unsupported version " + std::to_string(header.version));
+    }
+
+    LabelCheckpoint checkpoint;
+    checkpoint.iteration = header.iteration;
+    checkpoint.converged = header.converged != 0;
+    checkpoint.vertex_labels.resize(header.num_vertices);
+    checkpoint.hyperedge_labels.resize(header.num_hyperedges);
+    file.read(reinterpret_cast<char*>(checkpoint.vertex_labels.data()), static_cast<std::streamsize>(header.num_vertices * sizeof(std::uint32_t)));
+    file.read(reinterpret_cast<char*>(checkpoint.hyperedge_labels.data()), static_cast<std::streamsize>(header.num_hyperedges * sizeof(std::uint32_t)));
+    if (!file) throw std::runtime_error(path + " is truncated");
+    return checkpoint;
+}
+
+CheckpointWriter::CheckpointWriter(sycl::queue& queue, std::string path_, std::size_t num_vertices, std::size_t num_hyperedges)
+    : q(queue), path(std::move(path_)), N(num_vertices), E(num_hyperedges) {
+    vlabels_host = sycl::malloc_host<std::uint32_t>(std::max<std::size_t>(N, 1), q);
+    helabels_host = sycl::malloc_host<std::uint32_t>(std::max<std::size_t>(E, 1), q);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    // A failed write has nowhere to go from a destructor; finish() reports it to callers that ask.
+    if (pending.valid()) pending.wait();
+    sycl::free(vlabels_host, q);
+    sycl::free(helabels_host, q);
+}
+
+bool CheckpointWriter::capture(const std::uint32_t* vlabels_dev, const std::uint32_t* helabels_dev, std::uint64_t iteration, bool converged) {
+    if (pending.valid()) {
+        if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+        pending.get();
+    }
+
+    q.memcpy(vlabels_host, vlabels_dev, N * sizeof(std::uint32_t));
+    sycl::event copied = q.memcpy(helabels_host, helabels_dev, E * sizeof(std::uint32_t));
+    pending = std::async(std::launch::async, [this, copied, iteration, converged]() mutable {
+        copied.wait();
+        write_checkpoint(path, iteration, converged, vlabels_host, N, helabels_host, E);
+    });
+    captures++;
+    return true;
+}
+
+void CheckpointWriter::finish() {
+    if (pending.valid()) pending.get();
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "headers/cpu_backend.h"
+#include "headers/label_counting.h"
+#include "headers/parallel.h"
+
+namespace {
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+static_assert(MaxLabels == 16, "the vector histograms hold exactly 16 counters");
+#endif
+
+// Same result as most_frequent_label: the most frequent label below MaxLabels among
+// labels[indices[begin .. end)], the smallest one on ties, INVALID_LABEL when there is none.
+inline uint32_t row_label(const uint32_t* labels, const uint32_t* indices, size_t begin, size_t end) {
+#if defined(__AVX512F__)
+    // 16 x 32-bit counters; a label adds one to its own lane through the write mask.
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512i counts = _mm512_setzero_si512();
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t lbl = labels[indices[k]];
+        __mmask16 lane = lbl < MaxLabels ? static_cast<__mmask16>(1u << lbl) : 0;
+        counts = _mm512_mask_add_epi32(counts, lane, counts, one);
+    }
+
+    uint32_t max_count = _mm512_reduce_max_epu32(counts);
+    if (max_count == 0) return INVALID_LABEL;
+    __mmask16 at_max = _mm512_cmpeq_epi32_mask(counts, _mm512_set1_epi32(static_cast<int>(max_count)));
+    return static_cast<uint32_t>(__builtin_ctz(at_max));
+#elif defined(__AVX2__)
+    // 16 x 16-bit counters, so rows that could overflow one take the scalar path. A label's lane
+    // compares equal (all ones, i.e. -1) and is subtracted; labels >= MaxLabels match no lane.
+    if (end - begin >= 0xFFFF) {
+        uint32_t label_counts[MaxLabels];
+        return most_frequent_label(label_counts, labels, indices, begin, end);
+    }
+
+    const __m256i lanes = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m256i counts = _mm256_setzero_si256();
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t lbl = labels[indices[k]];
+        __m256i key = _mm256_set1_epi16(static_cast<short>(lbl < MaxLabels ? lbl : MaxLabels));
+        counts = _mm256_sub_epi16(counts, _mm256_cmpeq_epi16(lanes, key));
+    }
+
+    // minpos finds the smallest 16-bit lane, so the maximum is taken over the complemented counters.
+    __m128i halves = _mm_max_epu16(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+    __m128i min_complement = _mm_minpos_epu16(_mm_xor_si128(halves, _mm_set1_epi16(-1)));
+    uint32_t max_count = 0xFFFF - static_cast<uint32_t>(_mm_extract_epi16(min_complement, 0));
+    if (max_count == 0) return INVALID_LABEL;
+    uint32_t at_max = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(counts, _mm256_set1_epi16(static_cast<short>(max_count)))));
+    return static_cast<uint32_t>(__builtin_ctz(at_max)) / 2;
+#else
+    uint32_t label_counts[MaxLabels];
+    return most_frequent_label(label_counts, labels, indices, begin, end);
+#endif
+}
+
+}
+
+const char* cpu_simd_path() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+void find_communities_cpu(HypergraphSparse& H, PhaseTimings* timings, unsigned num_threads) {
+    const size_t N = H.num_vertices;
+    const size_t E = H.num_hyperedges;
+
+    ThreadPool pool(num_threads);
+
+    const size_t* voffsets = H.vertex_offsets.data();
+    const uint32_t* vhyperedges = H.vertex_hyperedges.data();
+    const size_t* heoffsets = H.hyperedge_offsets.data();
+    const uint32_t* hevertices = H.hyperedge_vertices.data();
+    uint32_t* vlabels = H.vertex_labels.data();
+    uint32_t* helabels = H.hyperedge_labels.data();
+
+    size_t iter = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    bool converged = false;
+    while (iter < MaxIterations && !converged) {
+        pool.parallel_blocks(E, CpuRowBlock, [&](size_t begin, size_t end) {
+            for (size_t e = begin; e < end; ++e) {
+                uint32_t best_label = row_label(vlabels, hevertices, heoffsets[e], heoffsets[e + 1]);
+                if (best_label != INVALID_LABEL) helabels[e] = best_label;
+            }
+        });
+
+        // One flag store per block that changed something, not per vertex.
+        std::atomic<bool> changed{false};
+        pool.parallel_blocks(N, CpuRowBlock, [&](size_t begin, size_t end) {
+            bool block_changed = false;
+            for (size_t v = begin; v < end; ++v) {
+                uint32_t best_label = row_label(helabels, vhyperedges, voffsets[v], voffsets[v + 1]);
+                if (best_label != INVALID_LABEL && best_label != vlabels[v]) {
+                    vlabels[v] = best_label;
+                    block_changed = true;
+                }
+            }
+            if (block_changed) changed.store(true, std::memory_order_relaxed);
+        });
+
+        ++iter;
+        converged = !changed.load(std::memory_order_relaxed);
+    }
+
+    double total_time_ms = elapsed_ms(start_time);
+    if (timings == nullptr) {
+        std::cout << "Total time cpu (ms): " << total_time_ms << " (" << pool.size() << " threads, " << cpu_simd_path() << ")" << std::endl;
+    } else {
+        *timings = {0, 0, 0, total_time_ms, 0, iter};
+    }
+}
+
+void find_communities_cpu(HypergraphNotSparse& H, PhaseTimings* timings, unsigned num_threads) {
+    auto phase_start = std::chrono::high_resolution_clock::now();
+    HypergraphSparse S = to_sparse(H);
+    double flatten_ms = elapsed_ms(phase_start);
+
+    find_communities_cpu(S, timings, num_threads);
+    if (timings != nullptr) timings->flatten_ms = flatten_ms;
+
+    H.vertex_labels = std::move(S.vertex_labels);
+    H.hyperedge_labels = std::move(S.hyperedge_labels);
+}
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "headers/dynamic.h"
+#include "headers/label_counting.h"
+
+namespace {
+
+using device_atomic = sycl::atomic_ref<uint32_t, sycl::memory_order::relaxed,
+                                       sycl::memory_scope::device,
+                                       sycl::access::address_space::global_space>;
+
+// Smallest slot a row gets, so short rows can take a few insertions before they move.
+constexpr uint32_t MinSlot = 4;
+// Smallest device row capacity, so a stream of single-entity batches does not regrow every time.
+constexpr size_t MinRowCapacity = 64;
+
+inline size_t round_up(size_t n) {
+    return (n + WorkGroupSize - 1) / WorkGroupSize * WorkGroupSize;
+}
+
+// Appends item to list unless its queued flag is already set.
+inline void push_once(uint32_t item, uint32_t* queued, uint32_t* list, uint32_t* list_size) {
+    if (device_atomic(queued[item]).exchange(1) == 0) {
+        list[device_atomic(*list_size).fetch_add(1)] = item;
+    }
+}
+
+// Reallocates a device array with room for capacity entries, keeping its first kept entries.
+template <typename T>
+void grow_device(sycl::queue& q, T*& ptr, size_t kept, size_t capacity) {
+    T* grown = sycl::malloc_device<T>(capacity, q);
+    if (ptr != nullptr) {
+        if (kept != 0) q.memcpy(grown, ptr, kept * sizeof(T)).wait();
+        sycl::free(ptr, q);
+    }
+    ptr = grown;
+}
+
+// Staging buffer of at least needed entries; the contents are not kept.
+template <typename T>
+void reserve_staging(sycl::queue& q, T*& ptr, size_t& capacity, size_t needed) {
+    if (needed <= capacity) return;
+    if (ptr != nullptr) sycl::free(ptr, q);
+    capacity = std::max(needed, 2 * capacity);
+    ptr = sycl::malloc_device<T>(capacity, q);
+}
+
+}
+
+DynamicLabelPropagation::DynamicLabelPropagation(const HypergraphSparse& H)
+    : DynamicLabelPropagation(H, sycl::queue(preferred_device(), sycl::property::queue::in_order())) {}
+
+DynamicLabelPropagation::DynamicLabelPropagation(const HypergraphSparse& H, const sycl::queue& queue)
+    : q(queue.is_in_order() ? queue : sycl::queue(queue.get_context(), queue.get_device(), sycl::property::queue::in_order())) {
+    list_sizes_dev = sycl::malloc_device<uint32_t>(2, q);
+    build(H);
+}
+
+DynamicLabelPropagation::~DynamicLabelPropagation() {
+    for (Side* side : {&vertices, &hyperedges}) {
+        for (void* p : {static_cast<void*>(side->begin_dev), static_cast<void*>(side->length_dev), static_cast<void*>(side->pool_dev),
+                        static_cast<void*>(side->labels_dev), static_cast<void*>(side->queued_dev), static_cast<void*>(side->list_dev),
+                        static_cast<void*>(side->next_dev)}) {
+            if (p != nullptr) sycl::free(p, q);
+        }
+    }
+    for (void* p : {static_cast<void*>(list_sizes_dev), static_cast<void*>(scratch_dev),
+                    static_cast<void*>(patch_records_dev), static_cast<void*>(patch_entries_dev)}) {
+        if (p != nullptr) sycl::free(p, q);
+    }
+}
+
+// Every row starts in a slot of twice its degree (at least MinSlot), laid out in row order.
+void DynamicLabelPropagation::build(const HypergraphSparse& H) {
+    auto layout = [](Side& side, size_t rows, const std::vector<size_t>& offsets, const std::vector<uint32_t>& indices) {
+        side.begin.resize(rows);
+        side.length.resize(rows);
+        side.capacity.resize(rows);
+        side.removed.assign(rows, 0);
+        side.dirty.assign(rows, 0);
+
+        size_t next = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            uint32_t length = static_cast<uint32_t>(offsets[r + 1] - offsets[r]);
+            side.begin[r] = next;
+            side.length[r] = length;
+            side.capacity[r] = std::max(MinSlot, 2 * length);
+            next += side.capacity[r];
+        }
+        side.pool.assign(next, 0);
+        for (size_t r = 0; r < rows; ++r) {
+            std::copy(indices.begin() + offsets[r], indices.begin() + offsets[r + 1], side.pool.begin() + side.begin[r]);
+        }
+    };
+
+    layout(vertices, H.num_vertices, H.vertex_offsets, H.vertex_hyperedges);
+    layout(hyperedges, H.num_hyperedges, H.hyperedge_offsets, H.hyperedge_vertices);
+    nnz = H.num_incidences();
+
+    for (auto [side, labels, with_next] : {std::make_tuple(&vertices, &H.vertex_labels, false),
+                                           std::make_tuple(&hyperedges, &H.hyperedge_labels, true)}) {
+        reserve_device(*side, with_next);
+        q.memcpy(side->begin_dev, side->begin.data(), side->begin.size() * sizeof(size_t));
+        q.memcpy(side->length_dev, side->length.data(), side->length.size() * sizeof(uint32_t));
+        q.memcpy(side->pool_dev, side->pool.data(), side->pool.size() * sizeof(uint32_t));
+        q.memcpy(side->labels_dev, labels->data(), labels->size() * sizeof(uint32_t));
+        q.wait();
+    }
+
+    counting = resolve_label_counting(LabelCounting::Auto, H.vertex_labels);
+}
+
+void DynamicLabelPropagation::add_rows(Side& side, size_t count) {
+    const size_t rows = side.length.size() + count;
+    side.begin.resize(rows, side.pool.size());
+    side.length.resize(rows, 0);
+    side.capacity.resize(rows, 0);
+    side.removed.resize(rows, 0);
+    side.dirty.resize(rows, 0);
+}
+
+void DynamicLabelPropagation::mark_dirty(Side& side, uint32_t row) {
+    if (side.dirty[row]) return;
+    side.dirty[row] = 1;
+    side.dirty_rows.push_back(row);
+}
+
+// A full row moves to a new slot at the end of the pool with room to double.
+void DynamicLabelPropagation::append(Side& side, uint32_t row, uint32_t item) {
+    if (side.length[row] == side.capacity[row]) {
+        const size_t begin = side.pool.size();
+        side.capacity[row] = std::max(MinSlot, 2 * side.capacity[row]);
+        side.pool.resize(begin + side.capacity[row], 0);
+        std::copy(side.pool.begin() + side.begin[row], side.pool.begin() + side.begin[row] + side.length[row], side.pool.begin() + begin);
+        side.begin[row] = begin;
+    }
+    side.pool[side.begin[row] + side.length[row]++] = item;
+    mark_dirty(side, row);
+}
+
+// Row order does not matter for counting, so the last entry fills the hole.
+bool DynamicLabelPropagation::erase(Side& side, uint32_t row, uint32_t item) {
+    uint32_t* first = side.pool.data() + side.begin[row];
+    uint32_t* last = first + side.length[row];
+    uint32_t* it = std::find(first, last, item);
+    if (it == last) return false;
+
+    *it = *(last - 1);
+    side.length[row]--;
+    mark_dirty(side, row);
+    return true;
+}
+
+// Grows the device arrays of a side to its current row count and pool size. Queued flags are zero
+// between sweeps and the work lists are rebuilt by every propagation, so neither is copied.
+void DynamicLabelPropagation::reserve_device(Side& side, bool with_next) {
+    const size_t rows = side.length.size();
+    if (rows > side.row_capacity || side.begin_dev == nullptr) {
+        const size_t capacity = std::max({rows, 2 * side.row_capacity, MinRowCapacity});
+        grow_device(q, side.begin_dev, side.row_capacity, capacity);
+        grow_device(q, side.length_dev, side.row_capacity, capacity);
+        grow_device(q, side.labels_dev, side.row_capacity, capacity);
+        grow_device(q, side.queued_dev, 0, capacity);
+        grow_device(q, side.list_dev, 0, capacity);
+        if (with_next) grow_device(q, side.next_dev, 0, capacity);
+        q.memset(side.queued_dev, 0, capacity * sizeof(uint32_t)).wait();
+        side.row_capacity = capacity;
+    }
+    if (side.pool.size() > side.pool_capacity || side.pool_dev == nullptr) {
+        const size_t capacity = std::max<size_t>({side.pool.size(), 2 * side.pool_capacity, 1});
+        grow_device(q, side.pool_dev, side.pool_capacity, capacity);
+        side.pool_capacity = capacity;
+    }
+}
+
+// Uploads the dirty rows of a side and the given label writes in two copies. Records hold
+// (row, begin, length, offset into the packed entries) for every dirty row, then (id, label) pairs.
+void DynamicLabelPropagation::upload_dirty(Side& side, const std::vector<std::pair<uint32_t, uint32_t>>& label_writes) {
+    const size_t rows = side.dirty_rows.size();
+    const size_t writes = label_writes.size();
+    if (rows + writes == 0) return;
+
+    std::vector<uint64_t> records;
+    std::vector<uint32_t> entries;
+    records.reserve(4 * rows + 2 * writes);
+    for (uint32_t r : side.dirty_rows) {
+        records.insert(records.end(), {r, side.begin[r], side.length[r], entries.size()});
+        entries.insert(entries.end(), side.pool.begin() + side.begin[r], side.pool.begin() + side.begin[r] + side.length[r]);
+    }
+    for (auto [id, label] : label_writes) records.insert(records.end(), {id, label});
+
+    reserve_staging(q, patch_records_dev, patch_records_capacity, records.size());
+    reserve_staging(q, patch_entries_dev, patch_entries_capacity, std::max<size_t>(entries.size(), 1));
+    q.memcpy(patch_records_dev, records.data(), records.size() * sizeof(uint64_t));
+    q.memcpy(patch_entries_dev, entries.data(), entries.size() * sizeof(uint32_t));
+
+    const uint64_t* records_dev = patch_records_dev;
+    const uint32_t* entries_dev = patch_entries_dev;
+    size_t* begin_dev = side.begin_dev;
+    uint32_t* length_dev = side.length_dev;
+    uint32_t* pool_dev = side.pool_dev;
+    uint32_t* labels_dev = side.labels_dev;
+    if (rows > 0) {
+        q.parallel_for(sycl::range<1>(rows), [=](sycl::id<1> i) {
+            const uint64_t* rec = records_dev + 4 * i[0];
+            const size_t begin = rec[1];
+            const uint32_t length = static_cast<uint32_t>(rec[2]);
+            begin_dev[rec[0]] = begin;
+            length_dev[rec[0]] = length;
+            for (uint32_t k = 0; k < length; ++k) pool_dev[begin + k] = entries_dev[rec[3] + k];
+        });
+    }
+    if (writes > 0) {
+        q.parallel_for(sycl::range<1>(writes), [=](sycl::id<1> i) {
+            const uint64_t* rec = records_dev + 4 * rows + 2 * i[0];
+            labels_dev[rec[0]] = static_cast<uint32_t>(rec[1]);
+        });
+    }
+    q.wait();
+}
+
+DynamicResult DynamicLabelPropagation::run(const std::vector<uint32_t>& seed_labels, const LabelPropagationOptions& options) {
+    assert(seed_labels.size() == num_vertices() && "seed_labels size mismatch");
+    counting = resolve_label_counting(options.label_counting, seed_labels);
+
+    std::vector<uint32_t> labels = seed_labels;
+    for (size_t v = 0; v < labels.size(); ++v) {
+        if (vertices.removed[v]) labels[v] = INVALID_LABEL;
+    }
+    q.memcpy(vertices.labels_dev, labels.data(), labels.size() * sizeof(uint32_t));
+    q.fill(hyperedges.labels_dev, INVALID_LABEL, num_hyperedges());
+    q.wait();
+
+    std::vector<uint32_t> hyperedge_seeds;
+    for (size_t e = 0; e < num_hyperedges(); ++e) {
+        if (!hyperedges.removed[e]) hyperedge_seeds.push_back(static_cast<uint32_t>(e));
+    }
+    return propagate(hyperedge_seeds, {}, options.max_iterations);
+}
+
+DynamicResult DynamicLabelPropagation::update(const HypergraphUpdate& batch, size_t max_iterations) {
+    auto apply_start = std::chrono::high_resolution_clock::now();
+
+    const uint32_t first_vertex = static_cast<uint32_t>(num_vertices());
+    const uint32_t first_hyperedge = static_cast<uint32_t>(num_hyperedges());
+    add_rows(vertices, batch.added_vertex_labels.size());
+    add_rows(hyperedges, batch.added_hyperedges.size());
+
+    // New rows are uploaded (as empty rows at least) and get their initial labels.
+    std::vector<std::pair<uint32_t, uint32_t>> vertex_label_writes, hyperedge_label_writes;
+    for (size_t i = 0; i < batch.added_vertex_labels.size(); ++i) {
+        mark_dirty(vertices, first_vertex + static_cast<uint32_t>(i));
+        vertex_label_writes.push_back({first_vertex + static_cast<uint32_t>(i), batch.added_vertex_labels[i]});
+    }
+    for (size_t j = 0; j < batch.added_hyperedges.size(); ++j) {
+        mark_dirty(hyperedges, first_hyperedge + static_cast<uint32_t>(j));
+        hyperedge_label_writes.push_back({first_hyperedge + static_cast<uint32_t>(j), INVALID_LABEL});
+    }
+
+    auto add_incidence = [this](uint32_t v, uint32_t e) {
+        if (v >= num_vertices() || e >= num_hyperedges() || vertices.removed[v] || hyperedges.removed[e]) return;
+        const uint32_t* row = vertices.pool.data() + vertices.begin[v];
+        if (std::find(row, row + vertices.length[v], e) != row + vertices.length[v]) return;
+        append(vertices, v, e);
+        append(hyperedges, e, v);
+        ++nnz;
+    };
+    auto remove_incidence = [this](uint32_t v, uint32_t e) {
+        if (v < num_vertices() && e < num_hyperedges() && erase(vertices, v, e)) {
+            erase(hyperedges, e, v);
+            --nnz;
+        }
+    };
+
+    for (size_t j = 0; j < batch.added_hyperedges.size(); ++j) {
+        for (uint32_t v : batch.added_hyperedges[j]) add_incidence(v, first_hyperedge + static_cast<uint32_t>(j));
+    }
+    for (auto [v, e] : batch.added_incidences) add_incidence(v, e);
+    for (auto [v, e] : batch.removed_incidences) remove_incidence(v, e);
+    for (uint32_t v : batch.removed_vertices) {
+        if (v >= num_vertices() || vertices.removed[v]) continue;
+        while (vertices.length[v] > 0) remove_incidence(v, vertices.pool[vertices.begin[v] + vertices.length[v] - 1]);
+        vertices.removed[v] = 1;
+        mark_dirty(vertices, v);
+        vertex_label_writes.push_back({v, INVALID_LABEL});
+    }
+    for (uint32_t e : batch.removed_hyperedges) {
+        if (e >= num_hyperedges() || hyperedges.removed[e]) continue;
+        while (hyperedges.length[e] > 0) remove_incidence(hyperedges.pool[hyperedges.begin[e] + hyperedges.length[e] - 1], e);
+        hyperedges.removed[e] = 1;
+        mark_dirty(hyperedges, e);
+        hyperedge_label_writes.push_back({e, INVALID_LABEL});
+    }
+
+    reserve_device(vertices, false);
+    reserve_device(hyperedges, true);
+    upload_dirty(vertices, vertex_label_writes);
+    upload_dirty(hyperedges, hyperedge_label_writes);
+
+    // Every row whose incidences changed is recomputed once; the sweeps take it from there.
+    std::vector<uint32_t> hyperedge_seeds, vertex_seeds;
+    for (auto [side, seeds] : {std::make_pair(&hyperedges, &hyperedge_seeds), std::make_pair(&vertices, &vertex_seeds)}) {
+        for (uint32_t r : side->dirty_rows) {
+            side->dirty[r] = 0;
+            if (!side->removed[r]) seeds->push_back(r);
+        }
+        side->dirty_rows.clear();
+    }
+    double apply_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - apply_start).count();
+
+    DynamicResult result = propagate(hyperedge_seeds, vertex_seeds, max_iterations);
+    result.apply_ms = apply_ms;
+    return result;
+}
+
+// The engine's active-set sweep, with two differences: the first hyperedge list is hyperedge_seeds
+// instead of every hyperedge, and vertex_seeds are queued for the first vertex phase whether or not
+// one of their hyperedges changes.
+DynamicResult DynamicLabelPropagation::propagate(const std::vector<uint32_t>& hyperedge_seeds, const std::vector<uint32_t>& vertex_seeds,
+                                                 size_t max_iterations) {
+    DynamicResult result;
+    const bool sparse = counting == LabelCounting::Sparse;
+    if (sparse) {
+        reserve_staging(q, scratch_dev, scratch_capacity, std::max(vertices.pool_capacity, hyperedges.pool_capacity));
+    }
+
+    const size_t* vbegin_dev = vertices.begin_dev;
+    const uint32_t* vlength_dev = vertices.length_dev;
+    const uint32_t* vpool_dev = vertices.pool_dev;
+    const size_t* hebegin_dev = hyperedges.begin_dev;
+    const uint32_t* helength_dev = hyperedges.length_dev;
+    const uint32_t* hepool_dev = hyperedges.pool_dev;
+    uint32_t* vlabels_dev = vertices.labels_dev;
+    uint32_t* helabels_dev = hyperedges.labels_dev;
+    uint32_t* v_list_dev = vertices.list_dev;
+    uint32_t* v_queued_dev = vertices.queued_dev;
+    uint32_t* he_list_dev = hyperedges.list_dev;
+    uint32_t* he_next_dev = hyperedges.next_dev;
+    uint32_t* he_queued_dev = hyperedges.queued_dev;
+    uint32_t* list_sizes_dev = this->list_sizes_dev;
+    uint32_t* scratch_dev = this->scratch_dev;
+
+    uint32_t he_count = static_cast<uint32_t>(hyperedge_seeds.size());
+    uint32_t v_count = static_cast<uint32_t>(vertex_seeds.size());
+    q.memcpy(he_list_dev, hyperedge_seeds.data(), he_count * sizeof(uint32_t));
+    q.memcpy(v_list_dev, vertex_seeds.data(), v_count * sizeof(uint32_t));
+    if (v_count > 0) {
+        q.parallel_for(sycl::range<1>(v_count), [=](sycl::id<1> i) { v_queued_dev[v_list_dev[i]] = 1; });
+    }
+    q.wait();
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    while (result.iterations < max_iterations) {
+        if (he_count == 0 && v_count == 0) {
+            result.converged = true;
+            break;
+        }
+
+        const uint32_t sizes[2] = {v_count, 0};
+        q.memcpy(list_sizes_dev, sizes, sizeof(sizes)).wait();
+
+        if (he_count > 0) {
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, sparse ? 1 : MaxLabels}, h);
+                h.parallel_for(sycl::nd_range<1>(round_up(he_count), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                    size_t i = idx.get_global_id(0);
+                    if (i >= he_count) return;
+
+                    uint32_t e = he_list_dev[i];
+                    he_queued_dev[e] = 0;
+
+                    const size_t begin = hebegin_dev[e], end = begin + helength_dev[e];
+                    uint32_t best_label = sparse
+                        ? most_frequent_label_sorted(scratch_dev, vlabels_dev, hepool_dev, begin, end)
+                        : most_frequent_label(label_counts_acc[idx.get_local_id(0)], vlabels_dev, hepool_dev, begin, end);
+                    if (best_label != helabels_dev[e]) {
+                        helabels_dev[e] = best_label;
+                        for (size_t k = begin; k < end; ++k) push_once(hepool_dev[k], v_queued_dev, v_list_dev, &list_sizes_dev[0]);
+                    }
+                });
+            }).wait();
+            q.memcpy(&v_count, &list_sizes_dev[0], sizeof(uint32_t)).wait();
+        }
+        result.rows_processed += he_count + v_count;
+
+        if (v_count > 0) {
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, sparse ? 1 : MaxLabels}, h);
+                h.parallel_for(sycl::nd_range<1>(round_up(v_count), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                    size_t i = idx.get_global_id(0);
+                    if (i >= v_count) return;
+
+                    uint32_t v = v_list_dev[i];
+                    v_queued_dev[v] = 0;
+
+                    const size_t begin = vbegin_dev[v], end = begin + vlength_dev[v];
+                    uint32_t best_label = sparse
+                        ? most_frequent_label_sorted(scratch_dev, helabels_dev, vpool_dev, begin, end)
+                        : most_frequent_label(label_counts_acc[idx.get_local_id(0)], helabels_dev, vpool_dev, begin, end);
+                    if (best_label != INVALID_LABEL && best_label != vlabels_dev[v]) {
+                        vlabels_dev[v] = best_label;
+                        for (size_t k = begin; k < end; ++k) push_once(vpool_dev[k], he_queued_dev, he_next_dev, &list_sizes_dev[1]);
+                    }
+                });
+            }).wait();
+            q.memcpy(&he_count, &list_sizes_dev[1], sizeof(uint32_t)).wait();
+        } else {
+            he_count = 0;
+        }
+        v_count = 0;
+
+        result.iterations++;
+        if (he_count == 0) {
+            result.converged = true;
+            break;
+        }
+        std::swap(he_list_dev, he_next_dev);
+    }
+
+    // Stopped by max_iterations: clear the flags of the hyperedges still queued.
+    if (!result.converged && he_count > 0) {
+        q.parallel_for(sycl::range<1>(he_count), [=](sycl::id<1> i) { he_queued_dev[he_list_dev[i]] = 0; }).wait();
+    }
+    hyperedges.list_dev = he_list_dev;
+    hyperedges.next_dev = he_next_dev;
+
+    result.time_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_time).count();
+    return result;
+}
+
+std::vector<uint32_t> DynamicLabelPropagation::vertex_labels() {
+    std::vector<uint32_t> labels(num_vertices());
+    q.memcpy(labels.data(), vertices.labels_dev, labels.size() * sizeof(uint32_t)).wait();
+    return labels;
+}
+
+std::vector<uint32_t> DynamicLabelPropagation::hyperedge_labels() {
+    std::vector<uint32_t> labels(num_hyperedges());
+    q.memcpy(labels.data(), hyperedges.labels_dev, labels.size() * sizeof(uint32_t)).wait();
+    return labels;
+}
+
+// Rows are sorted, so the snapshot matches a hypergraph built from the same incidences directly.
+HypergraphSparse DynamicLabelPropagation::snapshot() {
+    HypergraphSparse H;
+    H.num_vertices = num_vertices();
+    H.num_hyperedges = num_hyperedges();
+
+    auto compact = [](const Side& side, std::vector<size_t>& offsets, std::vector<uint32_t>& indices) {
+        offsets.assign(1, 0);
+        indices.clear();
+        for (size_t r = 0; r < side.length.size(); ++r) {
+            indices.insert(indices.end(), side.pool.begin() + side.begin[r], side.pool.begin() + side.begin[r] + side.length[r]);
+            std::sort(indices.begin() + offsets.back(), indices.end());
+            offsets.push_back(indices.size());
+        }
+    };
+    compact(vertices, H.vertex_offsets, H.vertex_hyperedges);
+    compact(hyperedges, H.hyperedge_offsets, H.hyperedge_vertices);
+
+    H.vertex_labels = vertex_labels();
+    H.hyperedge_labels = hyperedge_labels();
+    return H;
+}
@@ -0,0 +1,1059 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "headers/engine.h"
+#include "headers/label_counting.h"
+
+namespace {
+
+using device_atomic = sycl::atomic_ref<uint32_t, sycl::memory_order::relaxed,
+                                       sycl::memory_scope::device,
+                                       sycl::access::address_space::global_space>;
+
+using device_atomic64 = sycl::atomic_ref<uint64_t, sycl::memory_order::relaxed,
+                                         sycl::memory_scope::device,
+                                         sycl::access::address_space::global_space>;
+
+using local_atomic = sycl::atomic_ref<uint32_t, sycl::memory_order::relaxed,
+                                      sycl::memory_scope::work_group,
+                                      sycl::access::address_space::local_space>;
+
+// Packs (count, label) so that a max-reduction prefers the higher count, then the smaller label.
+inline uint64_t label_key(uint32_t count, uint32_t label) {
+    return (uint64_t(count) << 32) | (INVALID_LABEL - label);
+}
+
+inline uint32_t key_label(uint64_t key) {
+    return (key >> 32) == 0 ? INVALID_LABEL : INVALID_LABEL - static_cast<uint32_t>(key);
+}
+
+// Same result as most_frequent_label, computed by all lanes of g together: the lanes stride over the
+// row into one shared histogram and a group reduction picks the winner.
+template <typename Group>
+inline uint32_t group_most_frequent_label(Group g, uint32_t* label_counts, const uint32_t* labels, const uint32_t* indices, size_t begin, size_t end) {
+    const size_t lane = g.get_local_linear_id();
+    const size_t width = g.get_local_linear_range();
+
+    for (size_t i = lane; i < MaxLabels; i += width) label_counts[i] = 0;
+    sycl::group_barrier(g);
+
+    for (size_t k = begin + lane; k < end; k += width) {
+        uint32_t lbl = labels[indices[k]];
+        if (lbl < MaxLabels) {
+            local_atomic(label_counts[lbl]).fetch_add(1);
+        }
+    }
+    sycl::group_barrier(g);
+
+    uint64_t best = 0;
+    for (size_t i = lane; i < MaxLabels; i += width) {
+        best = std::max(best, label_key(label_counts[i], static_cast<uint32_t>(i)));
+    }
+    best = sycl::reduce_over_group(g, best, sycl::maximum<uint64_t>());
+    sycl::group_barrier(g);   // the histogram is cleared again for the next row
+    return key_label(best);
+}
+
+// Merge-path items (nonzeros plus row end markers) handled by one work-item of the nonzero-parallel kernel.
+constexpr size_t MergePathItemsPerThread = 32;
+
+// Local hash table sizes of the sparse counting path, per sub-group row and per work-group row.
+constexpr size_t SubGroupHashSlots = 128;
+constexpr size_t WorkGroupHashSlots = 1024;
+
+inline uint32_t hash_label(uint32_t lbl) {
+    lbl ^= lbl >> 16;
+    lbl *= 0x7FEB352Du;
+    lbl ^= lbl >> 15;
+    return lbl;
+}
+
+// Cooperative counting for any label value. table holds slots keys, slots counts and an overflow flag
+// (2 * slots + 1 entries, slots a power of two); lanes insert with linear probing. A row with more
+// distinct labels than slots sets the flag, and the group leader then recounts it with
+// most_frequent_label_sorted. The result is only meaningful in lane 0.
+template <typename Group>
+inline uint32_t group_most_frequent_label_hashed(Group g, uint32_t* table, size_t slots, uint32_t* scratch,
+                                                 const uint32_t* labels, const uint32_t* indices, size_t begin, size_t end) {
+    const size_t lane = g.get_local_linear_id();
+    const size_t width = g.get_local_linear_range();
+    uint32_t* keys = table;
+    uint32_t* counts = table + slots;
+    uint32_t* overflow = table + 2 * slots;
+
+    for (size_t i = lane; i < slots; i += width) {
+        keys[i] = INVALID_LABEL;
+        counts[i] = 0;
+    }
+    if (lane == 0) *overflow = 0;
+    sycl::group_barrier(g);
+
+    for (size_t k = begin + lane; k < end; k += width) {
+        uint32_t lbl = labels[indices[k]];
+        if (lbl == INVALID_LABEL) continue;
+
+        size_t probe = 0;
+        for (size_t slot = hash_label(lbl) & (slots - 1); probe < slots; slot = (slot + 1) & (slots - 1), ++probe) {
+            uint32_t expected = INVALID_LABEL;
+            if (local_atomic(keys[slot]).compare_exchange_strong(expected, lbl) || expected == lbl) {
+                local_atomic(counts[slot]).fetch_add(1);
+                break;
+            }
+        }
+        if (probe == slots) local_atomic(*overflow).store(1);
+    }
+    sycl::group_barrier(g);
+
+    uint32_t best_label;
+    if (*overflow != 0) {
+        best_label = lane == 0 ? most_frequent_label_sorted(scratch, labels, indices, begin, end) : INVALID_LABEL;
+    } else {
+        uint64_t best = 0;
+        for (size_t i = lane; i < slots; i += width) {
+            if (keys[i] != INVALID_LABEL) best = std::max(best, label_key(counts[i], keys[i]));
+        }
+        best_label = key_label(sycl::reduce_over_group(g, best, sycl::maximum<uint64_t>()));
+    }
+    sycl::group_barrier(g);   // the table is cleared again for the next row
+    return best_label;
+}
+
+// One side of a sweep: every row r takes the most frequent label of in_labels[indices[offsets[r] .. offsets[r + 1])].
+struct RowUpdate
+{
+    size_t rows;
+    const size_t* offsets;
+    const uint32_t* indices;
+    const uint32_t* in_labels;
+    uint32_t* out_labels;
+    int* changed_flag;   // raised when a row changes, nullptr to skip
+    uint32_t* scratch;   // one slot per incidence, used by the sparse counting path
+    const uint32_t* row_ids = nullptr;   // rows to update (rows entries), nullptr for 0 .. rows - 1
+    SweepStats* stats = nullptr;         // changes of this sweep, nullptr to skip
+    uint32_t side = 0;                   // 0 hyperedges, 1 vertices
+};
+
+inline size_t row_id(const RowUpdate& u, size_t i) {
+    return u.row_ids != nullptr ? u.row_ids[i] : i;
+}
+
+// One row's term of the label state hash (splitmix64 finalizer of side, row and label). The state hash is
+// the sum of the terms of all rows, so it does not depend on the update order and a change only adds the
+// difference of two terms.
+inline uint64_t label_hash(uint32_t side, size_t r, uint32_t label) {
+    uint64_t x = ((uint64_t(r) << 32) | label) ^ (side == 0 ? 0 : 0x9E3779B97F4A7C15ull);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline void record_change(SweepStats* stats, uint32_t side, size_t r, uint32_t old_label, uint32_t new_label) {
+    device_atomic(stats->changed[side]).fetch_add(1);
+    device_atomic64(stats->hash_delta).fetch_add(label_hash(side, r, new_label) - label_hash(side, r, old_label));
+}
+
+inline void store_label(const RowUpdate& u, size_t r, uint32_t best_label) {
+    if (best_label != INVALID_LABEL && u.out_labels[r] != best_label) {
+        if (u.stats != nullptr) record_change(u.stats, u.side, r, u.out_labels[r], best_label);
+        u.out_labels[r] = best_label;
+        if (u.changed_flag != nullptr) {
+            sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                             sycl::memory_scope::device,
+                             sycl::access::address_space::global_space>
+                af(*u.changed_flag);
+            af.store(1);
+        }
+    }
+}
+
+inline size_t round_up(size_t n) {
+    return (n + WorkGroupSize - 1) / WorkGroupSize * WorkGroupSize;
+}
+
+// Sub-groups walk the rows with a grid stride, so the launch does not depend on the sub-group size the
+// compiler picks; sub_group_size (the smallest one) only bounds how many sub-groups share a work-group.
+// Sparse selects the label counting: hash tables and per-row sorting instead of a MaxLabels histogram.
+template <bool Sparse>
+void submit_row_update(sycl::queue& q, RowMapping mapping, size_t sub_group_size, const RowUpdate& u) {
+    if (mapping == RowMapping::WorkItem) {
+        q.submit([&](sycl::handler& h) {
+            sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, Sparse ? 1 : MaxLabels}, h);
+            h.parallel_for(sycl::nd_range<1>(round_up(u.rows), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                size_t i = idx.get_global_id(0);
+                if (i >= u.rows) return;
+                size_t r = row_id(u, i);
+
+                uint32_t best_label;
+                if constexpr (Sparse) {
+                    best_label = most_frequent_label_sorted(u.scratch, u.in_labels, u.indices, u.offsets[r], u.offsets[r + 1]);
+                } else {
+                    best_label = most_frequent_label(label_counts_acc[idx.get_local_id(0)], u.in_labels, u.indices,
+                                                     u.offsets[r], u.offsets[r + 1]);
+                }
+                store_label(u, r, best_label);
+            });
+        });
+    } else if (mapping == RowMapping::SubGroup) {
+        const size_t max_sub_groups = WorkGroupSize / sub_group_size;
+        const size_t num_groups = (u.rows + max_sub_groups - 1) / max_sub_groups;
+        q.submit([&](sycl::handler& h) {
+            sycl::local_accessor<uint32_t, 2> label_counts_acc({max_sub_groups, Sparse ? 2 * SubGroupHashSlots + 1 : MaxLabels}, h);
+            h.parallel_for(sycl::nd_range<1>(num_groups * WorkGroupSize, WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                sycl::sub_group sg = idx.get_sub_group();
+                const size_t sub_groups = sg.get_group_linear_range();
+                uint32_t* label_counts = &label_counts_acc[sg.get_group_linear_id()][0];
+
+                for (size_t i = idx.get_group_linear_id() * sub_groups + sg.get_group_linear_id(); i < u.rows;
+                     i += idx.get_group_range(0) * sub_groups) {
+                    size_t r = row_id(u, i);
+                    uint32_t best_label;
+                    if constexpr (Sparse) {
+                        best_label = group_most_frequent_label_hashed(sg, label_counts, SubGroupHashSlots, u.scratch, u.in_labels,
+                                                                      u.indices, u.offsets[r], u.offsets[r + 1]);
+                    } else {
+                        best_label = group_most_frequent_label(sg, label_counts, u.in_labels, u.indices,
+                                                               u.offsets[r], u.offsets[r + 1]);
+                    }
+                    if (sg.get_local_linear_id() == 0) store_label(u, r, best_label);
+                }
+            });
+        });
+    } else {
+        q.submit([&](sycl::handler& h) {
+            sycl::local_accessor<uint32_t, 1> label_counts_acc(Sparse ? 2 * WorkGroupHashSlots + 1 : MaxLabels, h);
+            h.parallel_for(sycl::nd_range<1>(u.rows * WorkGroupSize, WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                size_t r = row_id(u, idx.get_group_linear_id());
+                uint32_t best_label;
+                if constexpr (Sparse) {
+                    best_label = group_most_frequent_label_hashed(idx.get_group(), &label_counts_acc[0], WorkGroupHashSlots, u.scratch,
+                                                                  u.in_labels, u.indices, u.offsets[r], u.offsets[r + 1]);
+                } else {
+                    best_label = group_most_frequent_label(idx.get_group(), &label_counts_acc[0], u.in_labels, u.indices,
+                                                           u.offsets[r], u.offsets[r + 1]);
+                }
+                if (idx.get_local_linear_id() == 0) store_label(u, r, best_label);
+            });
+        });
+    }
+}
+
+void submit_row_update(sycl::queue& q, RowMapping mapping, bool sparse, size_t sub_group_size, const RowUpdate& u) {
+    if (u.rows == 0) return;
+
+    if (sparse) {
+        submit_row_update<true>(q, mapping, sub_group_size, u);
+    } else {
+        submit_row_update<false>(q, mapping, sub_group_size, u);
+    }
+}
+
+// One launch per degree class, each over its own slice of the binned row list.
+void submit_binned_row_update(sycl::queue& q, const RowBins& bins, bool sparse, size_t sub_group_size, RowUpdate u) {
+    const RowMapping classes[RowBins::NumClasses] = {RowMapping::WorkItem, RowMapping::SubGroup, RowMapping::WorkGroup};
+    const uint32_t* rows = bins.rows_dev;
+    for (size_t c = 0; c < RowBins::NumClasses; ++c) {
+        u.rows = bins.sizes[c];
+        u.row_ids = rows;
+        submit_row_update(q, classes[c], sparse, sub_group_size, u);
+        rows += bins.sizes[c];
+    }
+}
+
+// Merge-path coordinates: the rows' end markers and the nonzeros form one sequence of rows + nnz items,
+// in which row r starts at r + offsets[r] and its end marker sits at r + offsets[r + 1]. Returns how many
+// rows end before diagonal d; the nonzeros before d are then d minus that count.
+inline size_t merge_path_search(const size_t* offsets, size_t rows, size_t nnz, size_t d) {
+    size_t lo = d > nnz ? d - nnz : 0;
+    size_t hi = std::min(d, rows);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (offsets[mid + 1] <= d - 1 - mid) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+inline size_t merge_path_chunks(size_t rows, size_t nnz) {
+    return (rows + nnz + MergePathItemsPerThread - 1) / MergePathItemsPerThread;
+}
+
+// Nonzero-parallel update: work-item c walks merge-path items [c * MergePathItemsPerThread, (c + 1) * ...),
+// so every work-item does the same amount of work whatever the degrees. Rows that lie entirely inside
+// a chunk are decided on the spot; the partial histograms of rows cut by a chunk boundary are added to
+// split_counts under the chunk the row starts in, and a second pass decides and clears those rows.
+// split_counts holds merge_path_chunks(rows, nnz) * MaxLabels zeroed counters. Histogram counting only.
+void submit_merge_path_update(sycl::queue& q, uint32_t* split_counts, const RowUpdate& u, size_t nnz) {
+    const size_t chunks = merge_path_chunks(u.rows, nnz);
+
+    q.submit([&](sycl::handler& h) {
+        sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+        h.parallel_for(sycl::nd_range<1>(round_up(chunks), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+            size_t c = idx.get_global_id(0);
+            if (c >= chunks) return;
+
+            auto label_counts = label_counts_acc[idx.get_local_id(0)];
+            const size_t d_begin = c * MergePathItemsPerThread;
+            const size_t d_end = std::min(d_begin + MergePathItemsPerThread, u.rows + nnz);
+            size_t r = merge_path_search(u.offsets, u.rows, nnz, d_begin);
+            const size_t r_end = merge_path_search(u.offsets, u.rows, nnz, d_end);
+            size_t k = d_begin - r;
+            const size_t k_end = d_end - r_end;
+
+            auto flush = [&](size_t row) {
+                uint32_t* split = split_counts + (row + u.offsets[row]) / MergePathItemsPerThread * MaxLabels;
+                for (size_t i = 0; i < MaxLabels; ++i) {
+                    if (label_counts[i] != 0) device_atomic(split[i]).fetch_add(label_counts[i]);
+                }
+            };
+
+            // Rows whose end marker falls inside the chunk.
+            for (; r < r_end; ++r) {
+                for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+                for (; k < u.offsets[r + 1]; ++k) {
+                    uint32_t lbl = u.in_labels[u.indices[k]];
+                    if (lbl < MaxLabels) label_counts[lbl]++;
+                }
+                if (r + u.offsets[r] >= d_begin) {
+                    store_label(u, r, histogram_argmax(label_counts));
+                } else {
+                    flush(r);
+                }
+            }
+
+            // The row still open at the end of the chunk continues into the next one.
+            if (r < u.rows && k < k_end) {
+                for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+                for (; k < k_end; ++k) {
+                    uint32_t lbl = u.in_labels[u.indices[k]];
+                    if (lbl < MaxLabels) label_counts[lbl]++;
+                }
+                flush(r);
+            }
+        });
+    });
+
+    // Chunk c finishes the row that starts in it and is still open at its end, if any.
+    q.parallel_for(sycl::range<1>(chunks), [=](sycl::id<1> c) {
+        const size_t d_begin = c * MergePathItemsPerThread;
+        const size_t d_end = d_begin + MergePathItemsPerThread;
+        if (d_end >= u.rows + nnz) return;
+
+        size_t r = merge_path_search(u.offsets, u.rows, nnz, d_end);
+        if (r >= u.rows || r + u.offsets[r] < d_begin || r + u.offsets[r] >= d_end) return;
+
+        uint32_t* split = split_counts + c * MaxLabels;
+        store_label(u, r, histogram_argmax(split));
+        for (size_t i = 0; i < MaxLabels; ++i) split[i] = 0;
+    });
+}
+
+// Queues one side of a sweep with the given (resolved) mapping.
+void submit_side(sycl::queue& q, RowMapping mapping, const RowBins& bins, uint32_t* split_counts, bool sparse,
+                 size_t sub_group_size, size_t nnz, const RowUpdate& u) {
+    if (mapping == RowMapping::Binned) {
+        submit_binned_row_update(q, bins, sparse, sub_group_size, u);
+    } else if (mapping == RowMapping::MergePath) {
+        if (u.rows > 0) submit_merge_path_update(q, split_counts, u, nnz);
+    } else {
+        submit_row_update(q, mapping, sparse, sub_group_size, u);
+    }
+}
+
+// Follows the sweep stats of a run and decides whether it should stop early. The state hash is only known
+// relative to the start of the run, which is all the cycle test needs.
+struct TerminationMonitor
+{
+    bool detect_oscillation;
+    size_t plateau_iterations;
+    size_t plateau_changes;       // a sweep changing at most this many vertices counts towards a plateau
+    uint64_t hashes[2] = {};      // state hash after the sweep before last and after the last sweep
+    size_t sweeps = 0;
+    size_t quiet = 0;
+
+    TerminationMonitor(const LabelPropagationOptions& options, size_t N)
+        : detect_oscillation(options.detect_oscillation), plateau_iterations(options.plateau_iterations),
+          plateau_changes(std::max<size_t>(1, static_cast<size_t>(std::ceil(options.plateau_fraction * N)))) {}
+
+    // Feeds the stats of the next sweep, which changed at least one vertex. Returns true, with the reason,
+    // when the run should stop after it.
+    bool stop_after(const SweepStats& s, Termination& reason) {
+        const uint64_t hash = hashes[1] + s.hash_delta;
+        if (detect_oscillation && ++sweeps >= 2 && hash == hashes[0]) {
+            reason = Termination::Oscillation;
+            return true;
+        }
+        quiet = s.changed[1] <= plateau_changes ? quiet + 1 : 0;
+        if (plateau_iterations > 0 && quiet >= plateau_iterations) {
+            reason = Termination::Plateau;
+            return true;
+        }
+        hashes[0] = hashes[1];
+        hashes[1] = hash;
+        return false;
+    }
+};
+
+// One work-item per (row, instance) of a batch: work-item g updates instance g % B of row g / B. The B
+// work-items of a row are neighbours, so they load each index together and read their labels from
+// consecutive addresses. changed[b] is raised when instance b changes a row, nullptr to skip.
+void submit_batched_update(sycl::queue& q, size_t rows, size_t B, const size_t* offsets, const uint32_t* indices,
+                           const uint32_t* in_labels, uint32_t* out_labels, int* changed) {
+    const size_t items = rows * B;
+    if (items == 0) return;
+
+    q.submit([&](sycl::handler& h) {
+        sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, MaxLabels}, h);
+        h.parallel_for(sycl::nd_range<1>(round_up(items), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+            size_t g = idx.get_global_id(0);
+            if (g >= items) return;
+            size_t r = g / B, b = g % B;
+
+            uint32_t best_label = most_frequent_label_interleaved(label_counts_acc[idx.get_local_id(0)], in_labels, B, b, indices,
+                                                                  offsets[r], offsets[r + 1]);
+            if (best_label != INVALID_LABEL && out_labels[g] != best_label) {
+                out_labels[g] = best_label;
+                if (changed != nullptr) {
+                    sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                     sycl::memory_scope::device,
+                                     sycl::access::address_space::global_space>
+                        af(changed[b]);
+                    af.store(1);
+                }
+            }
+        });
+    });
+}
+
+// Appends item to list unless its queued flag is already set.
+inline void push_once(uint32_t item, uint32_t* queued, uint32_t* list, uint32_t* list_size) {
+    if (device_atomic(queued[item]).exchange(1) == 0) {
+        list[device_atomic(*list_size).fetch_add(1)] = item;
+    }
+}
+
+}
+
+sycl::device preferred_device() {
+    try {
+        return sycl::device(sycl::gpu_selector_v);
+    } catch (const sycl::exception&) {
+        return sycl::device(sycl::cpu_selector_v);
+    }
+}
+
+LabelPropagationEngine::LabelPropagationEngine(const HypergraphSparse& H)
+    : LabelPropagationEngine(H, sycl::queue(preferred_device(), sycl::property::queue::in_order())) {}
+
+LabelPropagationEngine::LabelPropagationEngine(const HypergraphSparse& H, const sycl::queue& queue)
+    : q(queue.is_in_order() ? queue : sycl::queue(queue.get_context(), queue.get_device(), sycl::property::queue::in_order())),
+      N(H.num_vertices), E(H.num_hyperedges), NNZ(H.num_incidences()) {
+    std::vector<size_t> sub_group_sizes = q.get_device().get_info<sycl::info::device::sub_group_sizes>();
+    sub_group_size = sub_group_sizes.empty() ? 1 : *std::min_element(sub_group_sizes.begin(), sub_group_sizes.end());
+
+    vertex_degrees.resize(N);
+    for (size_t v = 0; v < N; ++v) vertex_degrees[v] = static_cast<uint32_t>(H.vertex_offsets[v + 1] - H.vertex_offsets[v]);
+    hyperedge_degrees.resize(E);
+    for (size_t e = 0; e < E; ++e) hyperedge_degrees[e] = static_cast<uint32_t>(H.hyperedge_offsets[e + 1] - H.hyperedge_offsets[e]);
+    max_vertex_degree = vertex_degrees.empty() ? 0 : *std::max_element(vertex_degrees.begin(), vertex_degrees.end());
+    max_hyperedge_degree = hyperedge_degrees.empty() ? 0 : *std::max_element(hyperedge_degrees.begin(), hyperedge_degrees.end());
+
+    voffsets_dev = sycl::malloc_device<size_t>(N + 1, q);
+    vhyperedges_dev = sycl::malloc_device<uint32_t>(NNZ, q);
+    heoffsets_dev = sycl::malloc_device<size_t>(E + 1, q);
+    hevertices_dev = sycl::malloc_device<uint32_t>(NNZ, q);
+    vlabels_dev = sycl::malloc_device<uint32_t>(N, q);
+    helabels_dev = sycl::malloc_device<uint32_t>(E, q);
+
+    q.memcpy(voffsets_dev, H.vertex_offsets.data(), (N + 1) * sizeof(size_t));
+    q.memcpy(vhyperedges_dev, H.vertex_hyperedges.data(), NNZ * sizeof(uint32_t));
+    q.memcpy(heoffsets_dev, H.hyperedge_offsets.data(), (E + 1) * sizeof(size_t));
+    q.memcpy(hevertices_dev, H.hyperedge_vertices.data(), NNZ * sizeof(uint32_t));
+    q.wait();
+}
+
+LabelPropagationEngine::~LabelPropagationEngine() {
+    sycl::free(voffsets_dev, q);
+    sycl::free(vhyperedges_dev, q);
+    sycl::free(heoffsets_dev, q);
+    sycl::free(hevertices_dev, q);
+    sycl::free(vlabels_dev, q);
+    sycl::free(helabels_dev, q);
+    if (changed_dev != nullptr) {
+        sycl::free(changed_dev, q);
+        sycl::free(stats_dev, q);
+    }
+    if (label_scratch_dev != nullptr) sycl::free(label_scratch_dev, q);
+    if (hyperedge_bins.rows_dev != nullptr) sycl::free(hyperedge_bins.rows_dev, q);
+    if (vertex_bins.rows_dev != nullptr) sycl::free(vertex_bins.rows_dev, q);
+    if (split_counts_dev != nullptr) sycl::free(split_counts_dev, q);
+    if (colors.vertex_rows_dev != nullptr) {
+        sycl::free(colors.vertex_rows_dev, q);
+        sycl::free(colors.hyperedge_rows_dev, q);
+    }
+    if (batch_vlabels_dev != nullptr) {
+        sycl::free(batch_vlabels_dev, q);
+        sycl::free(batch_helabels_dev, q);
+    }
+    if (batch_changed_dev != nullptr) sycl::free(batch_changed_dev, q);
+
+    if (he_list_dev != nullptr) {
+        sycl::free(he_list_dev, q);
+        sycl::free(he_next_dev, q);
+        sycl::free(v_list_dev, q);
+        sycl::free(he_queued_dev, q);
+        sycl::free(v_queued_dev, q);
+        sycl::free(list_sizes_dev, q);
+    }
+}
+
+LabelPropagationResult LabelPropagationEngine::run(const std::vector<uint32_t>& seed_labels, const LabelPropagationOptions& options) {
+    assert(seed_labels.size() == N && "seed_labels size mismatch");
+
+    q.memcpy(vlabels_dev, seed_labels.data(), N * sizeof(uint32_t)).wait();
+    q.fill(helabels_dev, INVALID_LABEL, E).wait();
+
+    LabelPropagationResult result;
+    result.label_counting = resolve_label_counting(options.label_counting, seed_labels);
+    return propagate(std::move(result), options);
+}
+
+// Labels only spread from the seeds, so the checkpoint labels resolve to the same counting path.
+LabelPropagationResult LabelPropagationEngine::resume(const LabelCheckpoint& checkpoint, const LabelPropagationOptions& options) {
+    assert(checkpoint.vertex_labels.size() == N && checkpoint.hyperedge_labels.size() == E && "checkpoint size mismatch");
+
+    q.memcpy(vlabels_dev, checkpoint.vertex_labels.data(), N * sizeof(uint32_t));
+    q.memcpy(helabels_dev, checkpoint.hyperedge_labels.data(), E * sizeof(uint32_t));
+    q.wait();
+
+    LabelPropagationResult result;
+    result.label_counting = resolve_label_counting(options.label_counting, checkpoint.vertex_labels);
+    result.iterations = checkpoint.iteration;
+    result.converged = checkpoint.converged;
+    return propagate(std::move(result), options);
+}
+
+LabelPropagationResult LabelPropagationEngine::propagate(LabelPropagationResult result, const LabelPropagationOptions& options) {
+    if (result.label_counting == LabelCounting::Sparse && label_scratch_dev == nullptr) {
+        label_scratch_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(NNZ, 1), q);
+    }
+
+    if (changed_capacity < options.max_iterations) {
+        if (changed_dev != nullptr) {
+            sycl::free(changed_dev, q);
+            sycl::free(stats_dev, q);
+        }
+        changed_dev = sycl::malloc_device<int>(options.max_iterations, q);
+        stats_dev = sycl::malloc_device<SweepStats>(options.max_iterations, q);
+        changed_capacity = options.max_iterations;
+    }
+
+    std::unique_ptr<CheckpointWriter> checkpoints;
+    if (options.checkpoint_interval > 0 && !options.checkpoint_path.empty()) {
+        checkpoints = std::make_unique<CheckpointWriter>(q, options.checkpoint_path, N, E);
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    if (result.converged) {
+        // Resumed from a fixed point: nothing left to do.
+    } else if (options.active_set) {
+        iterate_active_set(options, result, checkpoints.get());
+    } else {
+        iterate_full(options, result, checkpoints.get());
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    if (result.converged) result.termination = Termination::Converged;
+
+    if (checkpoints) {
+        checkpoints->finish();
+        checkpoints->capture(vlabels_dev, helabels_dev, result.iterations, result.converged);
+        checkpoints->finish();
+        result.checkpoints = checkpoints->written();
+    }
+
+    result.vertex_labels.resize(N);
+    result.hyperedge_labels.resize(E);
+    q.memcpy(result.vertex_labels.data(), vlabels_dev, N * sizeof(uint32_t));
+    q.memcpy(result.hyperedge_labels.data(), helabels_dev, E * sizeof(uint32_t));
+    q.wait();
+
+    return result;
+}
+
+// Sweeps are queued without host synchronization; iteration i raises changed_dev[i] when a vertex
+// changes, and the host reads the flags of a whole batch at once to find the first quiet iteration.
+// Sweeps queued after convergence leave the labels unchanged, since a converged state is a fixed point.
+// Checkpoints are taken after the flags of a batch are read, so a sweep queued after convergence is never
+// saved as an unconverged state; a converged run only gets the final checkpoint.
+void LabelPropagationEngine::iterate_full(const LabelPropagationOptions& options, LabelPropagationResult& result,
+                                          CheckpointWriter* checkpoints) {
+    q.memset(changed_dev, 0, options.max_iterations * sizeof(int));
+    SweepStats* stats = options.detect_oscillation || options.plateau_iterations > 0 ? stats_dev : nullptr;
+    if (stats != nullptr) q.memset(stats, 0, options.max_iterations * sizeof(SweepStats));
+    TerminationMonitor monitor(options, N);
+
+    const bool sparse = result.label_counting == LabelCounting::Sparse;
+    const RowMapping hyperedge_mapping = resolve_mapping(options.hyperedge_mapping, E, max_hyperedge_degree, sparse);
+    const RowMapping vertex_mapping = resolve_mapping(options.vertex_mapping, N, max_vertex_degree, sparse);
+    if (hyperedge_mapping == RowMapping::Binned && hyperedge_bins.rows_dev == nullptr) {
+        hyperedge_bins = build_bins(hyperedge_degrees);
+    }
+    if (vertex_mapping == RowMapping::Binned && vertex_bins.rows_dev == nullptr) {
+        vertex_bins = build_bins(vertex_degrees);
+    }
+    if ((hyperedge_mapping == RowMapping::MergePath || vertex_mapping == RowMapping::MergePath) && split_counts_dev == nullptr) {
+        size_t chunks = std::max(merge_path_chunks(N, NNZ), merge_path_chunks(E, NNZ));
+        split_counts_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(chunks, 1) * MaxLabels, q);
+        q.memset(split_counts_dev, 0, std::max<size_t>(chunks, 1) * MaxLabels * sizeof(uint32_t)).wait();
+    }
+
+    const bool colored = options.sweep_order == SweepOrder::Colored;
+    const size_t max_colors = std::min(std::max<size_t>(options.max_colors, 1), MaxColors);
+    if (colored && colors.max_colors != max_colors) {
+        if (colors.vertex_rows_dev != nullptr) {
+            sycl::free(colors.vertex_rows_dev, q);
+            sycl::free(colors.hyperedge_rows_dev, q);
+        }
+        colors = build_colors(max_colors);
+    }
+    if (colored) result.overflow_vertices = colors.overflow_vertices;
+    // Colored sweeps update lists of rows, which Binned and MergePath do not take; they use the average row class.
+    const RowMapping hyperedge_list_mapping = hyperedge_mapping == RowMapping::Binned || hyperedge_mapping == RowMapping::MergePath
+        ? row_class(E == 0 ? 0 : NNZ / E) : hyperedge_mapping;
+    const RowMapping vertex_list_mapping = vertex_mapping == RowMapping::Binned || vertex_mapping == RowMapping::MergePath
+        ? row_class(N == 0 ? 0 : NNZ / N) : vertex_mapping;
+
+    const size_t check_interval = std::max<size_t>(1, options.convergence_check_interval);
+    std::vector<int> changed_host(options.max_iterations);
+    std::vector<SweepStats> stats_host(stats != nullptr ? options.max_iterations : 0);
+
+    while (result.iterations < options.max_iterations && !result.converged) {
+        const size_t batch_start = result.iterations;
+        size_t batch_end = std::min(result.iterations + check_interval, options.max_iterations);
+        for (size_t it = result.iterations; it < batch_end; ++it) {
+            if (colored) {
+                const uint32_t* vertex_rows = colors.vertex_rows_dev;
+                const uint32_t* hyperedge_rows = colors.hyperedge_rows_dev;
+                for (size_t c = 0; c < colors.vertex_sizes.size(); ++c) {
+                    RowUpdate hyperedges = {colors.hyperedge_sizes[c], heoffsets_dev, hevertices_dev, vlabels_dev, helabels_dev, nullptr,
+                                            label_scratch_dev, hyperedge_rows, stats != nullptr ? stats + it : nullptr, 0};
+                    RowUpdate vertices = {colors.vertex_sizes[c], voffsets_dev, vhyperedges_dev, helabels_dev, vlabels_dev, changed_dev + it,
+                                          label_scratch_dev, vertex_rows, stats != nullptr ? stats + it : nullptr, 1};
+                    submit_row_update(q, hyperedge_list_mapping, sparse, sub_group_size, hyperedges);
+                    submit_row_update(q, vertex_list_mapping, sparse, sub_group_size, vertices);
+                    hyperedge_rows += colors.hyperedge_sizes[c];
+                    vertex_rows += colors.vertex_sizes[c];
+                }
+            } else {
+                RowUpdate hyperedges = {E, heoffsets_dev, hevertices_dev, vlabels_dev, helabels_dev, nullptr, label_scratch_dev,
+                                        nullptr, stats != nullptr ? stats + it : nullptr, 0};
+                RowUpdate vertices = {N, voffsets_dev, vhyperedges_dev, helabels_dev, vlabels_dev, changed_dev + it, label_scratch_dev,
+                                      nullptr, stats != nullptr ? stats + it : nullptr, 1};
+
+                submit_side(q, hyperedge_mapping, hyperedge_bins, split_counts_dev, sparse, sub_group_size, NNZ, hyperedges);
+                submit_side(q, vertex_mapping, vertex_bins, split_counts_dev, sparse, sub_group_size, NNZ, vertices);
+            }
+        }
+
+        q.memcpy(changed_host.data() + result.iterations, changed_dev + result.iterations, (batch_end - result.iterations) * sizeof(int));
+        if (stats != nullptr) {
+            q.memcpy(stats_host.data() + result.iterations, stats + result.iterations, (batch_end - result.iterations) * sizeof(SweepStats));
+        }
+        q.wait();
+
+        bool stopped = false;
+        while (result.iterations < batch_end && !result.converged && !stopped) {
+            const size_t it = result.iterations++;
+            result.converged = changed_host[it] == 0;
+            stopped = !result.converged && stats != nullptr && monitor.stop_after(stats_host[it], result.termination);
+        }
+        if (stopped) {
+            // The labels are those after the whole batch, so the sweeps queued after the stop count too,
+            // up to the point where one of them converged after all.
+            while (result.iterations < batch_end && !result.converged) {
+                result.converged = changed_host[result.iterations++] == 0;
+            }
+            break;
+        }
+        if (checkpoints != nullptr && !result.converged && batch_end / options.checkpoint_interval > batch_start / options.checkpoint_interval) {
+            checkpoints->capture(vlabels_dev, helabels_dev, batch_end);
+        }
+    }
+}
+
+// Same batching of the convergence checks as iterate_full, with one changed flag per iteration and instance.
+// An instance that has converged is a fixed point, so the sweeps the others still need leave it unchanged.
+std::vector<LabelPropagationResult> LabelPropagationEngine::run_batch(const std::vector<std::vector<uint32_t>>& seed_sets,
+                                                                      const LabelPropagationOptions& options) {
+    const size_t B = seed_sets.size();
+    if (B == 0) return {};
+    for (const std::vector<uint32_t>& seeds : seed_sets) assert(seeds.size() == N && "seed_labels size mismatch");
+
+    if (batch_capacity < B) {
+        if (batch_vlabels_dev != nullptr) {
+            sycl::free(batch_vlabels_dev, q);
+            sycl::free(batch_helabels_dev, q);
+        }
+        batch_vlabels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(N * B, 1), q);
+        batch_helabels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(E * B, 1), q);
+        batch_capacity = B;
+    }
+    if (batch_changed_capacity < options.max_iterations * B) {
+        if (batch_changed_dev != nullptr) sycl::free(batch_changed_dev, q);
+        batch_changed_dev = sycl::malloc_device<int>(std::max<size_t>(options.max_iterations * B, 1), q);
+        batch_changed_capacity = options.max_iterations * B;
+    }
+
+    std::vector<uint32_t> labels(std::max(N, E) * B);
+    for (size_t v = 0; v < N; ++v) {
+        for (size_t b = 0; b < B; ++b) labels[v * B + b] = seed_sets[b][v];
+    }
+    q.memcpy(batch_vlabels_dev, labels.data(), N * B * sizeof(uint32_t));
+    q.fill(batch_helabels_dev, INVALID_LABEL, E * B);
+    q.memset(batch_changed_dev, 0, options.max_iterations * B * sizeof(int));
+    q.wait();
+
+    std::vector<LabelPropagationResult> results(B);
+    std::vector<int> changed_host(options.max_iterations * B);
+    const size_t check_interval = std::max<size_t>(1, options.convergence_check_interval);
+    size_t iterations = 0;
+    size_t running = B;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    while (iterations < options.max_iterations && running > 0) {
+        size_t batch_end = std::min(iterations + check_interval, options.max_iterations);
+        for (size_t it = iterations; it < batch_end; ++it) {
+            submit_batched_update(q, E, B, heoffsets_dev, hevertices_dev, batch_vlabels_dev, batch_helabels_dev, nullptr);
+            submit_batched_update(q, N, B, voffsets_dev, vhyperedges_dev, batch_helabels_dev, batch_vlabels_dev,
+                                  batch_changed_dev + it * B);
+        }
+
+        q.memcpy(changed_host.data() + iterations * B, batch_changed_dev + iterations * B,
+                 (batch_end - iterations) * B * sizeof(int)).wait();
+        for (; iterations < batch_end && running > 0; ++iterations) {
+            for (size_t b = 0; b < B; ++b) {
+                LabelPropagationResult& result = results[b];
+                if (result.converged) continue;
+                result.iterations = iterations + 1;
+                if (changed_host[iterations * B + b] == 0) {
+                    result.converged = true;
+                    result.termination = Termination::Converged;
+                    --running;
+                }
+            }
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    const double time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+    for (LabelPropagationResult& result : results) {
+        result.time_ms = time_ms;
+        result.vertex_labels.resize(N);
+        result.hyperedge_labels.resize(E);
+    }
+    q.memcpy(labels.data(), batch_vlabels_dev, N * B * sizeof(uint32_t)).wait();
+    for (size_t v = 0; v < N; ++v) {
+        for (size_t b = 0; b < B; ++b) results[b].vertex_labels[v] = labels[v * B + b];
+    }
+    q.memcpy(labels.data(), batch_helabels_dev, E * B * sizeof(uint32_t)).wait();
+    for (size_t e = 0; e < E; ++e) {
+        for (size_t b = 0; b < B; ++b) results[b].hyperedge_labels[e] = labels[e * B + b];
+    }
+
+    return results;
+}
+
+// Rows shorter than a sub-group leave most lanes idle, so they stay on one work-item each; rows that
+// fill a work-group several times over get a whole work-group.
+RowMapping LabelPropagationEngine::row_class(size_t length) const {
+    if (length >= 4 * WorkGroupSize) return RowMapping::WorkGroup;
+    if (length >= 2 * sub_group_size) return RowMapping::SubGroup;
+    return RowMapping::WorkItem;
+}
+
+// A side whose longest row falls in a different class than its average row is skewed enough that a
+// single kernel shape either serializes on the long rows or idles lanes on the short ones.
+// The merge-path kernel only keeps histograms, so sparse label counting runs it as Binned instead.
+RowMapping LabelPropagationEngine::resolve_mapping(RowMapping mapping, size_t rows, size_t max_length, bool sparse) const {
+    if (mapping == RowMapping::MergePath && sparse) return RowMapping::Binned;
+    if (mapping != RowMapping::Auto) return mapping;
+
+    RowMapping average_class = row_class(rows == 0 ? 0 : NNZ / rows);
+    return row_class(max_length) == average_class ? average_class : RowMapping::Binned;
+}
+
+// Groups the row ids by class (work-item, sub-group, work-group rows, in that order, each ascending).
+// Only depends on the structure, so it is built once per side on first use.
+RowBins LabelPropagationEngine::build_bins(const std::vector<uint32_t>& degrees) {
+    const RowMapping classes[RowBins::NumClasses] = {RowMapping::WorkItem, RowMapping::SubGroup, RowMapping::WorkGroup};
+
+    RowBins bins;
+    std::vector<uint32_t> rows(degrees.size());
+    size_t next = 0;
+    for (size_t c = 0; c < RowBins::NumClasses; ++c) {
+        size_t begin = next;
+        for (size_t r = 0; r < degrees.size(); ++r) {
+            if (row_class(degrees[r]) == classes[c]) rows[next++] = static_cast<uint32_t>(r);
+        }
+        bins.sizes[c] = next - begin;
+    }
+
+    bins.rows_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(rows.size(), 1), q);
+    q.memcpy(bins.rows_dev, rows.data(), rows.size() * sizeof(uint32_t)).wait();
+    return bins;
+}
+
+// Jones-Plassmann coloring of the conflict structure (two vertices conflict when they share a hyperedge),
+// in rounds on the device. Each round, every hyperedge records the highest priority among its uncolored
+// vertices, and a vertex that holds that maximum in all of its hyperedges takes the smallest color none
+// of them holds yet. Such vertices never share a hyperedge, so each round colors an independent set in
+// parallel without atomics on taken[], and the result depends only on the priorities (a hash of the
+// vertex id, with the id as tie-break), not on the scheduling. A vertex that finds all max_colors colors
+// taken goes to the overflow class, bit max_colors of taken[]. max_colors is 1 .. MaxColors.
+ColorClasses LabelPropagationEngine::build_colors(size_t max_colors) {
+    const uint32_t overflow = static_cast<uint32_t>(max_colors);
+    const uint32_t all_colors = (1u << max_colors) - 1;
+    constexpr uint32_t NoColor = std::numeric_limits<uint32_t>::max();
+
+    uint32_t* color_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(N, 1), q);
+    uint32_t* taken_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(E, 1), q);
+    uint64_t* best_dev = sycl::malloc_device<uint64_t>(std::max<size_t>(E, 1), q);
+    uint32_t* colored_dev = sycl::malloc_device<uint32_t>(1, q);
+    q.fill(color_dev, NoColor, N);
+    q.memset(taken_dev, 0, E * sizeof(uint32_t));
+
+    const size_t* voffsets_dev = this->voffsets_dev;
+    const uint32_t* vhyperedges_dev = this->vhyperedges_dev;
+    const size_t* heoffsets_dev = this->heoffsets_dev;
+    const uint32_t* hevertices_dev = this->hevertices_dev;
+    // Priority of a vertex; 0 is left for "no uncolored vertex".
+    auto priority = [](size_t v) { return (label_hash(2, v, 0) & ~uint64_t(0xFFFFFFFF)) | (uint64_t(v) + 1); };
+
+    for (size_t colored = 0; colored < N;) {
+        q.memset(colored_dev, 0, sizeof(uint32_t));
+        if (E > 0) {
+            q.parallel_for(sycl::range<1>(E), [=](sycl::id<1> e) {
+                uint64_t best = 0;
+                for (size_t k = heoffsets_dev[e]; k < heoffsets_dev[e + 1]; ++k) {
+                    uint32_t u = hevertices_dev[k];
+                    if (color_dev[u] == NoColor) best = std::max(best, priority(u));
+                }
+                best_dev[e] = best;
+            });
+        }
+        q.parallel_for(sycl::range<1>(N), [=](sycl::id<1> idx) {
+            size_t v = idx[0];
+            if (color_dev[v] != NoColor) return;
+            const uint64_t key = priority(v);
+            uint32_t mask = 0;
+            for (size_t k = voffsets_dev[v]; k < voffsets_dev[v + 1]; ++k) {
+                if (best_dev[vhyperedges_dev[k]] != key) return;
+                mask |= taken_dev[vhyperedges_dev[k]];
+            }
+            const uint32_t free = ~mask & all_colors;
+            const uint32_t c = free != 0 ? static_cast<uint32_t>(__builtin_ctz(free)) : overflow;
+            for (size_t k = voffsets_dev[v]; k < voffsets_dev[v + 1]; ++k) taken_dev[vhyperedges_dev[k]] |= 1u << c;
+            color_dev[v] = c;
+            device_atomic(*colored_dev).fetch_add(1);
+        });
+        uint32_t round_colored = 0;
+        q.memcpy(&round_colored, colored_dev, sizeof(uint32_t)).wait();
+        colored += round_colored;
+    }
+
+    std::vector<uint32_t> color(N), taken(E);
+    q.memcpy(color.data(), color_dev, N * sizeof(uint32_t));
+    q.memcpy(taken.data(), taken_dev, E * sizeof(uint32_t));
+    q.wait();
+    sycl::free(color_dev, q);
+    sycl::free(taken_dev, q);
+    sycl::free(best_dev, q);
+    sycl::free(colored_dev, q);
+
+    // Class lists by counting sort, vertices and hyperedges in id order within each class.
+    ColorClasses classes;
+    classes.max_colors = max_colors;
+    std::vector<size_t> vertex_counts(max_colors + 1, 0);
+    for (uint32_t c : color) vertex_counts[c]++;
+    classes.overflow_vertices = vertex_counts[overflow];
+    size_t num_classes = max_colors + 1;
+    while (num_classes > 0 && vertex_counts[num_classes - 1] == 0) --num_classes;
+
+    classes.vertex_sizes.assign(vertex_counts.begin(), vertex_counts.begin() + num_classes);
+    classes.hyperedge_sizes.assign(num_classes, 0);
+    std::vector<size_t> vertex_start(num_classes + 1, 0);
+    for (size_t c = 0; c < num_classes; ++c) vertex_start[c + 1] = vertex_start[c] + classes.vertex_sizes[c];
+    std::vector<uint32_t> vertex_rows(N);
+    for (size_t v = 0; v < N; ++v) vertex_rows[vertex_start[color[v]]++] = static_cast<uint32_t>(v);
+
+    std::vector<uint32_t> hyperedge_rows;
+    for (size_t c = 0; c < num_classes; ++c) {
+        const size_t hyperedges_before = hyperedge_rows.size();
+        for (size_t e = 0; e < E; ++e) {
+            if (taken[e] & (1u << c)) hyperedge_rows.push_back(static_cast<uint32_t>(e));
+        }
+        classes.hyperedge_sizes[c] = hyperedge_rows.size() - hyperedges_before;
+    }
+
+    classes.vertex_rows_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(vertex_rows.size(), 1), q);
+    classes.hyperedge_rows_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(hyperedge_rows.size(), 1), q);
+    q.memcpy(classes.vertex_rows_dev, vertex_rows.data(), vertex_rows.size() * sizeof(uint32_t));
+    q.memcpy(classes.hyperedge_rows_dev, hyperedge_rows.data(), hyperedge_rows.size() * sizeof(uint32_t));
+    q.wait();
+    return classes;
+}
+
+// Labels only spread from the seeds, so the largest seed label bounds every label of the run.
+LabelCounting resolve_label_counting(LabelCounting counting, const std::vector<uint32_t>& seed_labels) {
+    if (counting != LabelCounting::Auto) return counting;
+
+    for (uint32_t lbl : seed_labels) {
+        if (lbl != INVALID_LABEL && lbl >= MaxLabels) return LabelCounting::Sparse;
+    }
+    return LabelCounting::Histogram;
+}
+
+void LabelPropagationEngine::allocate_frontier() {
+    if (he_list_dev != nullptr) return;
+
+    he_list_dev = sycl::malloc_device<uint32_t>(E, q);
+    he_next_dev = sycl::malloc_device<uint32_t>(E, q);
+    v_list_dev = sycl::malloc_device<uint32_t>(N, q);
+    he_queued_dev = sycl::malloc_device<uint32_t>(E, q);
+    v_queued_dev = sycl::malloc_device<uint32_t>(N, q);
+    list_sizes_dev = sycl::malloc_device<uint32_t>(2, q);
+
+    // The queued flags are cleared by the kernel that consumes each list, so they only need zeroing once.
+    q.memset(he_queued_dev, 0, E * sizeof(uint32_t));
+    q.memset(v_queued_dev, 0, N * sizeof(uint32_t));
+    q.wait();
+}
+
+// A hyperedge label can only change if one of its vertices changed in the previous sweep, and a vertex
+// label only if one of its hyperedges changed in this sweep, so both phases run over compacted work
+// lists instead of all rows. The first sweep starts from every hyperedge; an empty list means converged.
+void LabelPropagationEngine::iterate_active_set(const LabelPropagationOptions& options, LabelPropagationResult& result,
+                                                CheckpointWriter* checkpoints) {
+    allocate_frontier();
+
+    const size_t* voffsets_dev = this->voffsets_dev;
+    const uint32_t* vhyperedges_dev = this->vhyperedges_dev;
+    const size_t* heoffsets_dev = this->heoffsets_dev;
+    const uint32_t* hevertices_dev = this->hevertices_dev;
+    uint32_t* vlabels_dev = this->vlabels_dev;
+    uint32_t* helabels_dev = this->helabels_dev;
+    uint32_t* v_list_dev = this->v_list_dev;
+    uint32_t* he_queued_dev = this->he_queued_dev;
+    uint32_t* v_queued_dev = this->v_queued_dev;
+    uint32_t* list_sizes_dev = this->list_sizes_dev;
+    uint32_t* he_list_dev = this->he_list_dev;
+    uint32_t* he_next_dev = this->he_next_dev;
+    uint32_t* label_scratch_dev = this->label_scratch_dev;
+    const bool sparse = result.label_counting == LabelCounting::Sparse;
+    const bool monitored = options.detect_oscillation || options.plateau_iterations > 0;
+    TerminationMonitor monitor(options, N);
+
+    q.parallel_for(sycl::range<1>(E), [=](sycl::id<1> e) { he_list_dev[e] = static_cast<uint32_t>(e); }).wait();
+    uint32_t he_count = static_cast<uint32_t>(E);
+    uint32_t v_count = 0;
+
+    while (result.iterations < options.max_iterations) {
+        q.memset(list_sizes_dev, 0, 2 * sizeof(uint32_t));
+        SweepStats* stats = monitored ? stats_dev + result.iterations : nullptr;
+        if (stats != nullptr) q.memset(stats, 0, sizeof(SweepStats));
+        q.wait();
+
+        if (he_count > 0) {
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, sparse ? 1 : MaxLabels}, h);
+                h.parallel_for(sycl::nd_range<1>(round_up(he_count), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                    size_t i = idx.get_global_id(0);
+                    if (i >= he_count) return;
+
+                    uint32_t e = he_list_dev[i];
+                    he_queued_dev[e] = 0;
+
+                    uint32_t best_label = sparse
+                        ? most_frequent_label_sorted(label_scratch_dev, vlabels_dev, hevertices_dev, heoffsets_dev[e], heoffsets_dev[e + 1])
+                        : most_frequent_label(label_counts_acc[idx.get_local_id(0)], vlabels_dev, hevertices_dev,
+                                              heoffsets_dev[e], heoffsets_dev[e + 1]);
+                    if (best_label != INVALID_LABEL && best_label != helabels_dev[e]) {
+                        if (stats != nullptr) record_change(stats, 0, e, helabels_dev[e], best_label);
+                        helabels_dev[e] = best_label;
+                        for (size_t k = heoffsets_dev[e]; k < heoffsets_dev[e + 1]; ++k) {
+                            push_once(hevertices_dev[k], v_queued_dev, v_list_dev, &list_sizes_dev[0]);
+                        }
+                    }
+                });
+            }).wait();
+            q.memcpy(&v_count, &list_sizes_dev[0], sizeof(uint32_t)).wait();
+        } else {
+            v_count = 0;
+        }
+
+        if (v_count > 0) {
+            q.submit([&](sycl::handler& h) {
+                sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, sparse ? 1 : MaxLabels}, h);
+                h.parallel_for(sycl::nd_range<1>(round_up(v_count), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+                    size_t i = idx.get_global_id(0);
+                    if (i >= v_count) return;
+
+                    uint32_t v = v_list_dev[i];
+                    v_queued_dev[v] = 0;
+
+                    uint32_t best_label = sparse
+                        ? most_frequent_label_sorted(label_scratch_dev, helabels_dev, vhyperedges_dev, voffsets_dev[v], voffsets_dev[v + 1])
+                        : most_frequent_label(label_counts_acc[idx.get_local_id(0)], helabels_dev, vhyperedges_dev,
+                                              voffsets_dev[v], voffsets_dev[v + 1]);
+                    if (vlabels_dev[v] != best_label && best_label != INVALID_LABEL) {
+                        if (stats != nullptr) record_change(stats, 1, v, vlabels_dev[v], best_label);
+                        vlabels_dev[v] = best_label;
+                        for (size_t k = voffsets_dev[v]; k < voffsets_dev[v + 1]; ++k) {
+                            push_once(vhyperedges_dev[k], he_queued_dev, he_next_dev, &list_sizes_dev[1]);
+                        }
+                    }
+                });
+            }).wait();
+            q.memcpy(&he_count, &list_sizes_dev[1], sizeof(uint32_t)).wait();
+        } else {
+            he_count = 0;
+        }
+
+        result.iterations++;
+        if (he_count == 0) {
+            result.converged = true;
+            break;
+        }
+        if (checkpoints != nullptr && result.iterations % options.checkpoint_interval == 0) {
+            checkpoints->capture(vlabels_dev, helabels_dev, result.iterations);
+        }
+        std::swap(he_list_dev, he_next_dev);
+
+        if (stats != nullptr) {
+            SweepStats stats_host;
+            q.memcpy(&stats_host, stats, sizeof(SweepStats)).wait();
+            if (monitor.stop_after(stats_host, result.termination)) break;
+        }
+    }
+
+    // Stopped early or by max_iterations: clear the flags of the hyperedges still queued for the next run.
+    if (!result.converged && he_count > 0) {
+        q.parallel_for(sycl::range<1>(he_count), [=](sycl::id<1> i) { he_queued_dev[he_list_dev[i]] = 0; }).wait();
+    }
+
+    this->he_list_dev = he_list_dev;
+    this->he_next_dev = he_next_dev;
+}
@@ -1,6 +1,62 @@
+#ifndef ALGORITHMS_H
+#define ALGORITHMS_H
+
 #include "utils.h"
+#include "trace.h"
 #include <vector>
 #include <cstdint>
+#include <sycl/sycl.hpp>
+
+constexpr std::size_t MaxIterations = 100;
+constexpr std::size_t WorkGroupSize = 128;
+// Size of the dense label histograms. The dense, transpose and bitset kernels ignore larger labels;
+// the engine (and find_communities_sparse) switches to sparse label counting instead.
+constexpr std::size_t MaxLabels = 16;
+// Iterations queued between two host reads of the per-iteration changed flags.
+constexpr std::size_t ConvergenceCheckInterval = 8;
+
+// Wall-clock breakdown of one find_communities* call. When a caller passes one, the function fills it
+// instead of printing its total time.
+struct PhaseTimings
+{
+    double flatten_ms = 0;     // host-side preparation of the device layout (narrowing, CSR or bitset conversion)
+    double upload_ms = 0;      // host-to-device copies of the incidences and labels
+    double transpose_ms = 0;   // on-device transpose, 0 for variants without one
+    double propagate_ms = 0;   // all iterations, including the convergence checks
+    double download_ms = 0;    // device-to-host copies of the labels
+    std::size_t iterations = 0;
+};
+
+// Dense kernels, templated on the local-memory counter type and the label and incidence element types.
+// Counter must hold the largest vertex or hyperedge degree. Each of the three is instantiated for
+// uint8_t, uint16_t and uint32_t.
+// A non-null trace switches on event profiling and per-sweep changed-label counts (see trace.h).
+template <typename Counter = std::uint32_t, typename Label, typename Incidence>
+void find_communities(BasicHypergraphNotSparse<Label, Incidence>& H, PhaseTimings* timings = nullptr, PropagationTrace* trace = nullptr);
+template <typename Counter = std::uint32_t, typename Label, typename Incidence>
+void find_communities_transpose(BasicHypergraphNotSparse<Label, Incidence>& H, PhaseTimings* timings = nullptr,
+                                PropagationTrace* trace = nullptr);
+
+// Allocates incidence matrices (generate_hypergraph, IncidenceMatrix::resize) in USM of q's context.
+// The dense kernels read a sycl::usm::alloc::shared matrix in place and upload a sycl::usm::alloc::host
+// one from pinned memory, skipping the staging copy of pageable memory.
+IncidenceAllocation usm_incidence_allocation(const sycl::queue& q, sycl::usm::alloc kind);
+
+// Narrowest types that represent every label of H, count up to its largest degree without wrapping,
+// and encode its 0/1 incidences.
+struct DenseTypeSelection
+{
+    std::size_t label_bytes;
+    std::size_t counter_bytes;
+    std::size_t incidence_bytes;
+};
+
+DenseTypeSelection select_dense_types(const HypergraphNotSparse& H);
+
+// Runs find_communities (or find_communities_transpose) on a copy of H narrowed to the types chosen by
+// select_dense_types, then widens the resulting labels back into H.
+void find_communities_dispatch(HypergraphNotSparse& H, bool transpose = false, PhaseTimings* timings = nullptr);
+void find_communities_sparse(HypergraphSparse& H, PhaseTimings* timings = nullptr);
+void find_communities_bitset(HypergraphBitset& H, PhaseTimings* timings = nullptr);
 
-void find_communities(HypergraphNotSparse& H);
-void find_communities_transpose(HypergraphNotSparse& H);
+#endif
@@ -0,0 +1,74 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+#include <sycl/sycl.hpp>
+
+// Label checkpoint file (version 1): a 64-byte header, then the N vertex labels and the E hyperedge
+// labels as little-endian uint32_t, back to back.
+constexpr char CheckpointFileMagic[8] = {'H', 'Y', 'P', 'C', 'K', 'P', 'T', '\0'};
+constexpr std::uint32_t CheckpointFileVersion = 1;
+
+struct CheckpointFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t converged;       // 1 when the labels are a fixed point
+    std::uint64_t num_vertices;
+    std::uint64_t num_hyperedges;
+    std::uint64_t iteration;       // sweeps completed when the labels were taken
+    std::uint64_t reserved[3];
+};
+static_assert(sizeof(CheckpointFileHeader) == 64, "checkpoint header must be 64 bytes");
+
+// Label state of a run after some number of sweeps. Also the warm start of a new run: {0, false,
+// labels of an earlier run}.
+struct LabelCheckpoint
+{
+    std::uint64_t iteration = 0;
+    bool converged = false;
+    std::vector<std::uint32_t> vertex_labels;
+    std::vector<std::uint32_t> hyperedge_labels;
+};
+
+// The file is written next to path and renamed over it, so a run killed mid-write leaves the previous
+// checkpoint intact.
+void save_checkpoint(const LabelCheckpoint& checkpoint, const std::string& path);
+LabelCheckpoint load_checkpoint(const std::string& path);
+
+// Takes checkpoints of device-resident labels without stalling the queue. capture() enqueues copies
+// into pinned host buffers behind the work already on the (in-order) queue and returns at once; a
+// background task waits for the copies and writes the file. While a write is still in flight further
+// captures are skipped, so a slow disk lowers the checkpoint rate instead of the kernel rate.
+class CheckpointWriter
+{
+public:
+    CheckpointWriter(sycl::queue& q, std::string path, std::size_t num_vertices, std::size_t num_hyperedges);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    // Returns false when the previous checkpoint is still being written.
+    bool capture(const std::uint32_t* vlabels_dev, const std::uint32_t* helabels_dev, std::uint64_t iteration, bool converged = false);
+    // Waits for the write in flight, if any, and rethrows its error.
+    void finish();
+
+    std::size_t written() const { return captures; }
+
+private:
+    sycl::queue& q;
+    std::string path;
+    std::size_t N;
+    std::size_t E;
+    std::uint32_t* vlabels_host;
+    std::uint32_t* helabels_host;
+    std::future<void> pending;
+    std::size_t captures = 0;
+};
+
+#endif
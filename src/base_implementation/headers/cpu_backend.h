@@ -0,0 +1,23 @@
+#ifndef CPU_BACKEND_H
+#define CPU_BACKEND_H
+
+#include <cstddef>
+#include "algorithms.h"
+#include "utils.h"
+
+// Native CPU implementation of find_communities for machines without a usable SYCL device. It
+// produces the same labels: histogram counting over labels below MaxLabels, the smallest label on
+// ties, and sweeps until no vertex changes. The sweeps run on a thread pool over CSR/CSC rows in
+// blocks of CpuRowBlock consecutive rows. When the compiler targets AVX-512 or AVX2, the
+// MaxLabels-entry histogram and its argmax stay in one vector register.
+// num_threads = 0 uses all hardware threads.
+void find_communities_cpu(HypergraphNotSparse& H, PhaseTimings* timings = nullptr, unsigned num_threads = 0);
+void find_communities_cpu(HypergraphSparse& H, PhaseTimings* timings = nullptr, unsigned num_threads = 0);
+
+// Rows handed to a thread at a time. Consecutive rows read consecutive stretches of the index arrays.
+constexpr std::size_t CpuRowBlock = 256;
+
+// Histogram path compiled in: "avx512", "avx2" or "scalar".
+const char* cpu_simd_path();
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef DYNAMIC_H
+#define DYNAMIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "engine.h"
+#include "utils.h"
+
+// One batch of structural changes. New vertices get the ids num_vertices(), num_vertices() + 1, ... in
+// order, and new hyperedges likewise; the other fields of the same batch may already use those ids.
+// Removed ids are never reused: they stay in the id space with no incidences and an unlabeled label.
+// Adding an incidence that exists or names a removed or out-of-range id, or removing an incidence, vertex or
+// hyperedge that does not exist (removed before, or out of range), is a no-op.
+struct HypergraphUpdate
+{
+    std::vector<std::uint32_t> added_vertex_labels;                           // one new vertex per entry, with this seed label
+    std::vector<std::vector<std::uint32_t>> added_hyperedges;                 // the vertices of each new hyperedge
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> added_incidences;    // (vertex, hyperedge)
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> removed_incidences;  // (vertex, hyperedge)
+    std::vector<std::uint32_t> removed_vertices;
+    std::vector<std::uint32_t> removed_hyperedges;
+};
+
+struct DynamicResult
+{
+    std::size_t iterations = 0;       // active-set sweeps, including the last one
+    bool converged = false;           // false when max_iterations was reached first
+    std::size_t rows_processed = 0;   // hyperedge and vertex rows recomputed over all sweeps
+    double apply_ms = 0;              // host bookkeeping and device patching of the batch (0 for run)
+    double time_ms = 0;               // propagation
+};
+
+// Label propagation on a hypergraph that changes between runs. Both incidence directions stay resident
+// in slack storage: every row owns a slot of a shared pool with room to grow, and a row that outgrows
+// its slot moves to a new one at the end of the pool. A batch therefore only rewrites the rows it
+// touches, and uploads just those rows. Slots left behind by moved rows are not reclaimed.
+//
+// Propagation is the engine's active-set sweep, started from the rows whose incidences changed instead
+// of from every hyperedge, and from the current labels instead of the seeds. Work is proportional to the
+// part of the hypergraph whose labels actually move, not to its size. Hyperedge labels are always the
+// argmax of their vertices' labels (unlabeled when none is labeled), so a hyperedge that loses all its
+// labeled vertices is unlabeled again; vertices keep their label when none of their hyperedges is labeled.
+class DynamicLabelPropagation
+{
+public:
+    // Starts from the labels stored in H, e.g. the converged labels of an earlier run.
+    explicit DynamicLabelPropagation(const HypergraphSparse& H);
+    DynamicLabelPropagation(const HypergraphSparse& H, const sycl::queue& q);
+    ~DynamicLabelPropagation();
+
+    DynamicLabelPropagation(const DynamicLabelPropagation&) = delete;
+    DynamicLabelPropagation& operator=(const DynamicLabelPropagation&) = delete;
+
+    // Propagation from scratch: vertices restart from seed_labels (one per vertex id), hyperedges from
+    // unlabeled. Uses options.max_iterations and options.label_counting; the counting chosen here is kept
+    // by later updates. Until the first run the counting is resolved from the labels of H.
+    DynamicResult run(const std::vector<std::uint32_t>& seed_labels, const LabelPropagationOptions& options = {});
+
+    // Applies the batch, then propagates from the current labels until they are stable again.
+    DynamicResult update(const HypergraphUpdate& batch, std::size_t max_iterations = MaxIterations);
+
+    // Current labels, downloaded on demand; removed ids read as unlabeled.
+    std::vector<std::uint32_t> vertex_labels();
+    std::vector<std::uint32_t> hyperedge_labels();
+
+    // The current structure and labels as a regular hypergraph, with removed ids left empty.
+    HypergraphSparse snapshot();
+
+    std::size_t num_vertices() const { return vertices.length.size(); }
+    std::size_t num_hyperedges() const { return hyperedges.length.size(); }
+    std::size_t num_incidences() const { return nnz; }
+    LabelCounting label_counting() const { return counting; }
+    sycl::queue& queue() { return q; }
+
+private:
+    // One side (vertices or hyperedges): row r is pool[begin[r] .. begin[r] + length[r]) inside a slot of
+    // capacity[r] entries. The host keeps a mirror of everything it needs to edit rows.
+    struct Side
+    {
+        std::vector<std::size_t> begin;
+        std::vector<std::uint32_t> length;
+        std::vector<std::uint32_t> capacity;
+        std::vector<std::uint32_t> pool;
+        std::vector<std::uint8_t> removed;
+        std::vector<std::uint8_t> dirty;          // row rewritten by the current batch
+        std::vector<std::uint32_t> dirty_rows;
+
+        std::size_t row_capacity = 0;             // rows allocated on the device
+        std::size_t pool_capacity = 0;            // pool entries allocated on the device
+        std::size_t* begin_dev = nullptr;
+        std::uint32_t* length_dev = nullptr;
+        std::uint32_t* pool_dev = nullptr;
+        std::uint32_t* labels_dev = nullptr;
+        std::uint32_t* queued_dev = nullptr;      // active-set "already listed" flags, zero between sweeps
+        std::uint32_t* list_dev = nullptr;        // active-set work list
+        std::uint32_t* next_dev = nullptr;        // next sweep's work list (hyperedges only)
+    };
+
+    void build(const HypergraphSparse& H);
+    void add_rows(Side& side, std::size_t count);
+    void append(Side& side, std::uint32_t row, std::uint32_t item);
+    bool erase(Side& side, std::uint32_t row, std::uint32_t item);
+    void mark_dirty(Side& side, std::uint32_t row);
+    void reserve_device(Side& side, bool with_next);
+    void upload_dirty(Side& side, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& label_writes);
+    DynamicResult propagate(const std::vector<std::uint32_t>& hyperedge_seeds, const std::vector<std::uint32_t>& vertex_seeds,
+                            std::size_t max_iterations);
+
+    sycl::queue q;
+    Side vertices;     // CSR: hyperedges of each vertex
+    Side hyperedges;   // CSC: vertices of each hyperedge
+    std::size_t nnz = 0;
+    LabelCounting counting = LabelCounting::Histogram;
+
+    std::uint32_t* list_sizes_dev = nullptr;
+    std::uint32_t* scratch_dev = nullptr;          // sparse counting, one slot per pool entry of the larger pool
+    std::size_t scratch_capacity = 0;
+    std::uint64_t* patch_records_dev = nullptr;    // staging of upload_dirty
+    std::size_t patch_records_capacity = 0;
+    std::uint32_t* patch_entries_dev = nullptr;
+    std::size_t patch_entries_capacity = 0;
+};
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "algorithms.h"
+#include "checkpoint.h"
+#include "utils.h"
+
+// How the rows of one side (hyperedges or vertices) are assigned to work-items in full sweeps.
+//   WorkItem  : one work-item scans a whole row, private histogram slice in local memory
+//   SubGroup  : one sub-group per row, lanes stride over the row into a shared local histogram
+//   WorkGroup : one work-group per row, for rows much longer than a sub-group
+//   Binned    : rows grouped by degree into the three classes above, one specialized launch per class
+//   MergePath : nonzero-parallel; every work-item takes an equal slice of rows + nnz and rows cut by a
+//               slice boundary are finished by a second pass (Histogram counting only, else Binned)
+//   Auto      : Binned when the longest row of a side falls in another class than its average row,
+//               otherwise the class of the average row
+enum class RowMapping
+{
+    Auto,
+    WorkItem,
+    SubGroup,
+    WorkGroup,
+    Binned,
+    MergePath,
+};
+
+// Row ids of one side grouped by degree class: sizes[0] work-item rows, then sizes[1] sub-group rows,
+// then sizes[2] work-group rows.
+struct RowBins
+{
+    static constexpr std::size_t NumClasses = 3;
+
+    std::uint32_t* rows_dev = nullptr;
+    std::size_t sizes[NumClasses] = {};
+};
+
+// Order of the row updates inside a full sweep.
+//   Synchronous : all hyperedges, then all vertices, each phase from the labels of the previous one
+//   Colored     : vertices in color classes in which, as far as options.max_colors colors allow, no two
+//                 vertices share a hyperedge. The classes are updated one after the other, each right after the
+//                 hyperedges it touches, so every class reads the labels its predecessors just wrote
+//                 (Gauss-Seidel instead of Jacobi). Different labels than Synchronous, usually in fewer sweeps.
+enum class SweepOrder
+{
+    Synchronous,
+    Colored,
+};
+
+// Largest options.max_colors: colors are bits of a 32-bit mask, and the bit after the last color marks the
+// overflow class. Every hyperedge is recomputed once per color among its vertices, so more colors make a
+// sweep dearer.
+constexpr std::size_t MaxColors = 31;
+
+// Vertex ids grouped by color, and for every color the hyperedges incident to at least one of its vertices.
+// Vertices whose hyperedges already hold all max_colors colors form a last, overflow class; vertices of that
+// class may share hyperedges and then read each other's labels from before the class update.
+struct ColorClasses
+{
+    std::uint32_t* vertex_rows_dev = nullptr;
+    std::uint32_t* hyperedge_rows_dev = nullptr;
+    std::vector<std::size_t> vertex_sizes;      // one entry per class in use
+    std::vector<std::size_t> hyperedge_sizes;
+    std::size_t max_colors = 0;                 // cap the classes were built with
+    std::size_t overflow_vertices = 0;          // size of the overflow class, 0 for a proper coloring
+};
+
+// Why a run stopped.
+//   Converged     : a sweep changed no vertex label
+//   Oscillation   : the labels came back to those of two sweeps earlier, so they flip between two states
+//   Plateau       : plateau_iterations sweeps in a row each changed at most plateau_fraction of the vertices
+//                   (at least one vertex)
+//   MaxIterations : max_iterations sweeps ran first
+enum class Termination
+{
+    Converged,
+    Oscillation,
+    Plateau,
+    MaxIterations,
+};
+
+// Changes of one sweep, collected on the device while early termination is enabled: the changed hyperedge
+// and vertex labels, and what the sweep added to the rolling hash of both label vectors.
+struct SweepStats
+{
+    std::uint32_t changed[2];   // hyperedges, vertices
+    std::uint64_t hash_delta;
+};
+
+// How the labels of a row are counted.
+//   Histogram : dense MaxLabels-entry histogram; labels >= MaxLabels are ignored
+//   Sparse    : any label value; per-row sort-and-reduce for work-item rows, local hash tables
+//               (falling back to sorting when a row has too many distinct labels) for cooperative rows
+//   Auto      : Histogram when every seed label is below MaxLabels, Sparse otherwise
+enum class LabelCounting
+{
+    Auto,
+    Histogram,
+    Sparse,
+};
+
+// Device the default-constructed queues run on: a GPU when there is one, otherwise the CPU device (for
+// instance on CPU-only batch nodes, or with ONEAPI_DEVICE_SELECTOR=opencl:cpu).
+sycl::device preferred_device();
+
+// Counting path a run with these seeds takes: counting itself unless it is Auto.
+LabelCounting resolve_label_counting(LabelCounting counting, const std::vector<std::uint32_t>& seed_labels);
+
+struct LabelPropagationOptions
+{
+    std::size_t max_iterations = MaxIterations;
+
+    // Full sweeps are queued in batches of this many iterations and the host reads the per-iteration
+    // changed flags once per batch. 1 checks after every iteration.
+    std::size_t convergence_check_interval = ConvergenceCheckInterval;
+
+    // Active-set mode: after the first sweep only hyperedges incident to changed vertices, and only
+    // vertices incident to changed hyperedges, are re-evaluated. Results match the full sweeps exactly.
+    bool active_set = false;
+
+    // Kernel shape of the full sweeps; active-set sweeps always use one work-item per row.
+    RowMapping hyperedge_mapping = RowMapping::Auto;
+    RowMapping vertex_mapping = RowMapping::Auto;
+
+    // Full sweeps only; active-set sweeps are always synchronous. Colored sweeps use at most max_colors
+    // (1 .. MaxColors) proper color classes; see ColorClasses for the vertices that do not fit.
+    SweepOrder sweep_order = SweepOrder::Synchronous;
+    std::size_t max_colors = 8;
+
+    LabelCounting label_counting = LabelCounting::Auto;
+
+    // Every checkpoint_interval sweeps (0 = never) the labels are written to checkpoint_path in the
+    // background, and once more when the run ends. Full sweeps take these checkpoints at the convergence
+    // check that follows, so at most one per convergence_check_interval sweeps.
+    std::size_t checkpoint_interval = 0;
+    std::string checkpoint_path;
+
+    // Early termination for runs that keep changing without settling. detect_oscillation stops a run whose
+    // labels return to those of two sweeps earlier (2-cycles), compared through an order-independent hash
+    // of both label vectors that only the changed rows update. plateau_iterations > 0 stops after that many
+    // consecutive sweeps each changing at most max(1, ceil(plateau_fraction * N)) vertex labels. Full sweeps
+    // notice either condition at the next convergence check, so the sweeps queued up to it still run.
+    bool detect_oscillation = false;
+    std::size_t plateau_iterations = 0;
+    double plateau_fraction = 0.001;
+};
+
+struct LabelPropagationResult
+{
+    std::vector<std::uint32_t> vertex_labels;
+    std::vector<std::uint32_t> hyperedge_labels;
+
+    std::size_t iterations = 0;   // sweeps executed, including the final one that changed nothing
+    bool converged = false;       // false when max_iterations was reached first
+    Termination termination = Termination::MaxIterations;
+    double time_ms = 0;           // propagation only, label upload and download excluded
+    LabelCounting label_counting = LabelCounting::Histogram;   // path actually used, never Auto
+    std::size_t checkpoints = 0;  // checkpoints written, including the final one
+    std::size_t overflow_vertices = 0;   // colored sweeps: vertices in the overflow color class
+};
+
+// Keeps the queue and the uploaded CSR/CSC incidence structure of one hypergraph resident, so
+// repeated runs (different seeds, parameter sweeps) only pay for the label upload and the iterations.
+// The engine relies on in-order execution; an out-of-order queue is replaced by an in-order one on the same device.
+class LabelPropagationEngine
+{
+public:
+    explicit LabelPropagationEngine(const HypergraphSparse& H);
+    LabelPropagationEngine(const HypergraphSparse& H, const sycl::queue& q);
+    ~LabelPropagationEngine();
+
+    LabelPropagationEngine(const LabelPropagationEngine&) = delete;
+    LabelPropagationEngine& operator=(const LabelPropagationEngine&) = delete;
+
+    // seed_labels holds one label per vertex (all ones = unlabeled); hyperedges start unlabeled.
+    LabelPropagationResult run(const std::vector<std::uint32_t>& seed_labels, const LabelPropagationOptions& options = {});
+
+    // Continues from a checkpoint: sweeps start from its labels and options.max_iterations counts the
+    // sweeps already in it. A resumed run ends with the labels and iteration count of the uninterrupted
+    // one. A checkpoint {0, false, labels of an earlier run} warm-starts a new run from those labels.
+    LabelPropagationResult resume(const LabelCheckpoint& checkpoint, const LabelPropagationOptions& options = {});
+
+    // Propagates several independent seed sets at once, one result per set. The label vectors are stored
+    // interleaved (labels[row * B + instance]) and every kernel updates all B instances of a row with
+    // neighbouring work-items, so each incidence index is loaded once per sweep for the whole batch.
+    // Full synchronous sweeps with histogram counting (labels >= MaxLabels are ignored); the other options
+    // except max_iterations and convergence_check_interval do not apply. The sweeps go on until every
+    // instance has converged; each result reports its own iterations and the time of the whole batch.
+    std::vector<LabelPropagationResult> run_batch(const std::vector<std::vector<std::uint32_t>>& seed_sets,
+                                                  const LabelPropagationOptions& options = {});
+
+    std::size_t num_vertices() const { return N; }
+    std::size_t num_hyperedges() const { return E; }
+    std::size_t num_incidences() const { return NNZ; }
+    sycl::queue& queue() { return q; }
+
+private:
+    LabelPropagationResult propagate(LabelPropagationResult result, const LabelPropagationOptions& options);
+    void iterate_full(const LabelPropagationOptions& options, LabelPropagationResult& result, CheckpointWriter* checkpoints);
+    void iterate_active_set(const LabelPropagationOptions& options, LabelPropagationResult& result, CheckpointWriter* checkpoints);
+    void allocate_frontier();
+    RowMapping row_class(std::size_t length) const;
+    RowMapping resolve_mapping(RowMapping mapping, std::size_t rows, std::size_t max_length, bool sparse) const;
+    RowBins build_bins(const std::vector<std::uint32_t>& degrees);
+    ColorClasses build_colors(std::size_t max_colors);
+
+    sycl::queue q;
+    std::size_t N;
+    std::size_t E;
+    std::size_t NNZ;
+    std::size_t sub_group_size;   // smallest sub-group size of the device
+
+    std::vector<std::uint32_t> vertex_degrees;
+    std::vector<std::uint32_t> hyperedge_degrees;
+    std::size_t max_vertex_degree;
+    std::size_t max_hyperedge_degree;
+
+    std::size_t* voffsets_dev;
+    std::uint32_t* vhyperedges_dev;
+    std::size_t* heoffsets_dev;
+    std::uint32_t* hevertices_dev;
+    std::uint32_t* vlabels_dev;
+    std::uint32_t* helabels_dev;
+    int* changed_dev = nullptr;        // changed flag of every iteration of the current run
+    std::size_t changed_capacity = 0;
+    SweepStats* stats_dev = nullptr;   // per-iteration changes of the current run, with early termination
+    std::uint32_t* label_scratch_dev = nullptr;   // NNZ entries, allocated by the first sparse-counting run
+    RowBins vertex_bins;                           // built by the first binned run of each side
+    RowBins hyperedge_bins;
+    std::uint32_t* split_counts_dev = nullptr;     // merge-path partial histograms of rows cut by a chunk boundary
+    ColorClasses colors;                           // built by the first colored run with each max_colors
+
+    // Interleaved label vectors and per-iteration, per-instance changed flags of batched runs.
+    std::uint32_t* batch_vlabels_dev = nullptr;
+    std::uint32_t* batch_helabels_dev = nullptr;
+    std::size_t batch_capacity = 0;                // instances
+    int* batch_changed_dev = nullptr;
+    std::size_t batch_changed_capacity = 0;
+
+    // Active-set buffers, allocated on first use: hyperedge work lists (current and next), the vertex
+    // work list, "already queued" flags for both, and the two list sizes.
+    std::uint32_t* he_list_dev = nullptr;
+    std::uint32_t* he_next_dev = nullptr;
+    std::uint32_t* v_list_dev = nullptr;
+    std::uint32_t* he_queued_dev = nullptr;
+    std::uint32_t* v_queued_dev = nullptr;
+    std::uint32_t* list_sizes_dev = nullptr;
+};
+
+#endif
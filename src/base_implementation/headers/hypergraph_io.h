@@ -0,0 +1,134 @@
+#ifndef HYPERGRAPH_IO_H
+#define HYPERGRAPH_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "utils.h"
+
+// Binary hypergraph file (version 1): a 64-byte header followed by 64-byte aligned sections
+//   vertex labels (N x label_width), hyperedge labels (E x label_width), then the incidence payload:
+//   Dense  : N x E uint8_t, row-major
+//   Bitset : N x words_per_row uint64_t, same layout as HypergraphBitset
+//   CSR    : vertex_offsets (N + 1 uint64_t), vertex_hyperedges (nnz uint32_t),
+//            hyperedge_offsets (E + 1 uint64_t), hyperedge_vertices (nnz uint32_t)
+// All values are little-endian, so a mapped file can be used in place.
+constexpr char HypergraphFileMagic[8] = {'H', 'Y', 'P', 'G', 'R', 'P', 'H', '\0'};
+constexpr std::uint32_t HypergraphFileVersion = 1;
+constexpr std::size_t HypergraphFileAlignment = 64;
+
+enum class HypergraphLayout : std::uint32_t
+{
+    Dense = 0,
+    Bitset = 1,
+    CSR = 2,
+};
+
+struct HypergraphFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t layout;
+    std::uint64_t num_vertices;
+    std::uint64_t num_hyperedges;
+    std::uint64_t num_incidences;
+    std::uint64_t words_per_row;
+    std::uint32_t label_width;
+    std::uint32_t reserved[3];
+};
+static_assert(sizeof(HypergraphFileHeader) == HypergraphFileAlignment, "header must fill one alignment block");
+
+// Byte offsets of every section, derived from the header alone.
+struct HypergraphFileSections
+{
+    std::uint64_t vertex_labels;
+    std::uint64_t hyperedge_labels;
+    std::uint64_t dense_incidence;
+    std::uint64_t incidence_bits;
+    std::uint64_t vertex_offsets;
+    std::uint64_t vertex_hyperedges;
+    std::uint64_t hyperedge_offsets;
+    std::uint64_t hyperedge_vertices;
+    std::uint64_t file_size;
+};
+
+HypergraphFileSections hypergraph_file_sections(const HypergraphFileHeader& header);
+
+// Read-only memory mapping of a whole file (empty files map to a null pointer).
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// Hypergraph file mapped in place. Section pointers refer directly into the mapping,
+// nothing is copied until a load_* helper materializes an in-memory hypergraph.
+class MappedHypergraph
+{
+public:
+    explicit MappedHypergraph(const std::string& path);
+
+    const HypergraphFileHeader& header() const { return *reinterpret_cast<const HypergraphFileHeader*>(file.data()); }
+    const HypergraphFileSections& sections() const { return offsets; }
+    HypergraphLayout layout() const { return static_cast<HypergraphLayout>(header().layout); }
+
+    template <typename T>
+    const T* section(std::uint64_t offset) const { return reinterpret_cast<const T*>(file.data() + offset); }
+
+    const std::uint8_t* dense_incidence() const { return section<std::uint8_t>(offsets.dense_incidence); }
+    const std::uint64_t* incidence_bits() const { return section<std::uint64_t>(offsets.incidence_bits); }
+    const std::uint64_t* vertex_offsets() const { return section<std::uint64_t>(offsets.vertex_offsets); }
+    const std::uint32_t* vertex_hyperedges() const { return section<std::uint32_t>(offsets.vertex_hyperedges); }
+    const std::uint64_t* hyperedge_offsets() const { return section<std::uint64_t>(offsets.hyperedge_offsets); }
+    const std::uint32_t* hyperedge_vertices() const { return section<std::uint32_t>(offsets.hyperedge_vertices); }
+
+    // Widens or narrows the stored labels to uint32_t, keeping the all-ones unlabeled marker.
+    void read_vertex_labels(std::vector<std::uint32_t>& out) const;
+    void read_hyperedge_labels(std::vector<std::uint32_t>& out) const;
+
+private:
+    MappedFile file;
+    HypergraphFileSections offsets;
+};
+
+void save_hypergraph(const HypergraphNotSparse& H, const std::string& path);
+void save_hypergraph(const HypergraphSparse& H, const std::string& path);
+void save_hypergraph(const HypergraphBitset& H, const std::string& path);
+
+// Each loader accepts any stored layout and converts when it differs from the requested one.
+// Paths ending in .hgr or .mtx are parsed as text with read_hmetis / read_matrix_market.
+HypergraphNotSparse load_hypergraph_dense(const std::string& path);
+HypergraphSparse load_hypergraph_sparse(const std::string& path);
+HypergraphBitset load_hypergraph_bitset(const std::string& path);
+
+// Text inputs, parsed straight into CSR/CSC by num_threads threads (0 = all hardware threads).
+// Ids are 1-based, duplicate incidences are dropped, and every vertex starts unlabeled.
+//   hMETIS .hgr    : "E N [fmt]" header, then one line of vertex ids per hyperedge
+//                    (fmt 1/11 put a hyperedge weight first; fmt 10/11 vertex weight lines are ignored)
+//   MatrixMarket   : "coordinate" matrix with one "vertex hyperedge [value]" entry per line;
+//                    rows are vertices, columns are hyperedges, explicit zeros are skipped
+HypergraphSparse read_hmetis(const std::string& path, unsigned num_threads = 0);
+HypergraphSparse read_matrix_market(const std::string& path, unsigned num_threads = 0);
+
+// Reads seed labels in the nodes_label.txt format (whitespace-separated integers, negative = unlabeled)
+// into labels, which must already have one entry per vertex.
+void read_seed_labels(const std::string& path, std::vector<std::uint32_t>& labels);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef LABEL_COUNTING_H
+#define LABEL_COUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include "algorithms.h"
+
+// Per-row label counting shared by the device kernels of the engine and the partitioned runner.
+// Every helper runs inside a single work-item.
+
+constexpr std::uint32_t INVALID_LABEL = std::numeric_limits<std::uint32_t>::max();
+
+// Label with the highest count in a MaxLabels-entry histogram, the smallest one on ties; INVALID_LABEL when all counts are 0.
+template <typename Counts>
+inline uint32_t histogram_argmax(const Counts& label_counts) {
+    uint32_t max_count = 0, best_label = INVALID_LABEL;
+    for (size_t i = 0; i < MaxLabels; ++i) {
+        if (label_counts[i] > max_count) {
+            max_count = label_counts[i];
+            best_label = i;
+        }
+    }
+    return best_label;
+}
+
+// Most frequent label among labels[indices[begin .. end)], ignoring unlabeled entries and labels
+// >= MaxLabels; the smallest label wins ties. INVALID_LABEL when no neighbour is labeled.
+template <typename Counts>
+inline uint32_t most_frequent_label(Counts label_counts, const uint32_t* labels, const uint32_t* indices, size_t begin, size_t end) {
+    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t lbl = labels[indices[k]];
+        if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+            label_counts[lbl]++;
+        }
+    }
+
+    return histogram_argmax(label_counts);
+}
+
+// most_frequent_label for instance lane of a batch whose labels are interleaved: the label of row j in that
+// instance is labels[j * stride + lane].
+template <typename Counts>
+inline uint32_t most_frequent_label_interleaved(Counts label_counts, const uint32_t* labels, size_t stride, size_t lane,
+                                                const uint32_t* indices, size_t begin, size_t end) {
+    for (size_t i = 0; i < MaxLabels; ++i) label_counts[i] = 0;
+
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t lbl = labels[indices[k] * stride + lane];
+        if (lbl < MaxLabels && lbl != INVALID_LABEL) {
+            label_counts[lbl]++;
+        }
+    }
+
+    return histogram_argmax(label_counts);
+}
+
+// Sorts a[0 .. n) ascending: insertion sort for short rows, heapsort otherwise (no recursion, no extra memory).
+inline void sort_labels(uint32_t* a, size_t n) {
+    if (n <= 16) {
+        for (size_t i = 1; i < n; ++i) {
+            uint32_t x = a[i];
+            size_t j = i;
+            for (; j > 0 && a[j - 1] > x; --j) a[j] = a[j - 1];
+            a[j] = x;
+        }
+        return;
+    }
+
+    auto sift_down = [a](size_t root, size_t size) {
+        uint32_t x = a[root];
+        for (size_t child = 2 * root + 1; child < size; child = 2 * root + 1) {
+            if (child + 1 < size && a[child + 1] > a[child]) ++child;
+            if (a[child] <= x) break;
+            a[root] = a[child];
+            root = child;
+        }
+        a[root] = x;
+    };
+    for (size_t i = n / 2; i-- > 0;) sift_down(i, n);
+    for (size_t end = n - 1; end > 0; --end) {
+        std::swap(a[0], a[end]);
+        sift_down(0, end);
+    }
+}
+
+// Most frequent label among labels[indices[begin .. end)] for any label value. The labeled entries are
+// gathered into scratch[begin .. end) (scratch has one slot per incidence), sorted, and the longest run
+// wins; runs are visited in ascending order, so the smallest label wins ties as in most_frequent_label.
+inline uint32_t most_frequent_label_sorted(uint32_t* scratch, const uint32_t* labels, const uint32_t* indices, size_t begin, size_t end) {
+    uint32_t* row = scratch + begin;
+    size_t n = 0;
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t lbl = labels[indices[k]];
+        if (lbl != INVALID_LABEL) row[n++] = lbl;
+    }
+    sort_labels(row, n);
+
+    uint32_t max_count = 0, best_label = INVALID_LABEL;
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && row[j] == row[i]) ++j;
+        if (j - i > max_count) {
+            max_count = static_cast<uint32_t>(j - i);
+            best_label = row[i];
+        }
+        i = j;
+    }
+    return best_label;
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline unsigned resolve_num_threads(unsigned num_threads) {
+    return num_threads != 0 ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+inline std::size_t chunk_size(std::size_t n, unsigned num_threads) {
+    return std::max<std::size_t>(1, (n + num_threads - 1) / num_threads);
+}
+
+// Splits [0, n) into one contiguous chunk of chunk_size(n, num_threads) per thread and runs f(begin, end) on each.
+template <typename F>
+void parallel_chunks(std::size_t n, unsigned num_threads, F f) {
+    std::vector<std::thread> threads;
+    std::size_t chunk = chunk_size(n, num_threads);
+    for (unsigned t = 0; t < num_threads; ++t) {
+        std::size_t begin = std::min(n, t * chunk);
+        std::size_t end = std::min(n, begin + chunk);
+        threads.emplace_back(f, begin, end);
+    }
+    for (auto& th : threads) th.join();
+}
+
+// Persistent workers for loops that run many short parallel passes (one per propagation phase), where
+// starting threads per pass as parallel_chunks does would cost more than the pass itself.
+class ThreadPool
+{
+public:
+    // num_threads = 0 uses all hardware threads; the calling thread is one of them.
+    explicit ThreadPool(unsigned num_threads = 0) {
+        num_threads = resolve_num_threads(num_threads);
+        for (unsigned t = 1; t < num_threads; ++t) workers.emplace_back([this] { work(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Splits [0, n) into blocks of block_size and runs f(begin, end) on every block. Threads claim the
+    // next block as they finish one, so uneven blocks balance out. Returns when all blocks are done.
+    void parallel_blocks(std::size_t n, std::size_t block_size, std::function<void(std::size_t, std::size_t)> f) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            job = std::move(f);
+            job_size = n;
+            job_block = std::max<std::size_t>(1, block_size);
+            next_block.store(0, std::memory_order_relaxed);
+            busy = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        run_blocks();
+
+        std::unique_lock<std::mutex> lock(m);
+        done.wait(lock, [this] { return busy == 0; });
+    }
+
+private:
+    void run_blocks() {
+        for (;;) {
+            std::size_t begin = next_block.fetch_add(1, std::memory_order_relaxed) * job_block;
+            if (begin >= job_size) return;
+            job(begin, std::min(job_size, begin + job_block));
+        }
+    }
+
+    void work() {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            run_blocks();
+            std::lock_guard<std::mutex> lock(m);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    std::size_t generation = 0;
+    std::size_t busy = 0;
+
+    std::function<void(std::size_t, std::size_t)> job;
+    std::size_t job_size = 0;
+    std::size_t job_block = 1;
+    std::atomic<std::size_t> next_block{0};
+};
+
+#endif
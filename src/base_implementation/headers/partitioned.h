@@ -0,0 +1,109 @@
+#ifndef PARTITIONED_H
+#define PARTITIONED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "engine.h"
+#include "utils.h"
+
+// Owner partition of every vertex and hyperedge.
+struct HypergraphPartition
+{
+    std::size_t num_parts = 1;
+    std::vector<std::uint32_t> vertex_part;
+    std::vector<std::uint32_t> hyperedge_part;
+};
+
+// Vertices are cut into num_parts contiguous ranges holding about the same number of incidences, and
+// every hyperedge goes to the part owning most of its vertices (the lowest one on ties), so hyperedges
+// whose vertices share a range never cross a partition boundary.
+HypergraphPartition partition_hypergraph(const HypergraphSparse& H, std::size_t num_parts);
+
+// One in-order, profiling queue per GPU when there are several, otherwise one per NUMA sub-device of
+// the CPU when it can be partitioned, otherwise a single default queue. max_queues = 0 keeps them all.
+std::vector<sycl::queue> partition_queues(std::size_t max_queues = 0);
+
+struct PartitionStats
+{
+    std::size_t num_vertices = 0;      // owned
+    std::size_t num_hyperedges = 0;    // owned
+    std::size_t halo_vertices = 0;     // remote vertices read by owned hyperedges
+    std::size_t halo_hyperedges = 0;   // remote hyperedges read by owned vertices
+    std::size_t num_incidences = 0;    // incidences of owned vertices plus incidences of owned hyperedges
+    double compute_ms = 0;             // kernel time from profiling events, 0 on queues without profiling
+};
+
+struct PartitionedResult : LabelPropagationResult
+{
+    double exchange_ms = 0;   // host time spent moving boundary labels between partitions
+    std::vector<PartitionStats> partitions;
+};
+
+// Label propagation split over several queues. Each partition keeps the CSC rows of its hyperedges and
+// the CSR rows of its vertices, renumbered locally: owned entries first, then halo copies of the remote
+// entries they read. After each half-sweep every partition packs the owned labels other partitions read
+// into a boundary array, which goes through host memory (the queues may live in different contexts)
+// and is scattered into the halos. Partitions may share a queue.
+class PartitionedLabelPropagation
+{
+public:
+    PartitionedLabelPropagation(const HypergraphSparse& H, std::vector<sycl::queue> queues);
+    PartitionedLabelPropagation(const HypergraphSparse& H, std::vector<sycl::queue> queues, const HypergraphPartition& partition);
+    ~PartitionedLabelPropagation();
+
+    PartitionedLabelPropagation(const PartitionedLabelPropagation&) = delete;
+    PartitionedLabelPropagation& operator=(const PartitionedLabelPropagation&) = delete;
+
+    // Same semantics as LabelPropagationEngine::run for max_iterations and label_counting; every sweep
+    // is a full sweep with one work-item per row, and convergence is checked after every iteration.
+    PartitionedResult run(const std::vector<std::uint32_t>& seed_labels, const LabelPropagationOptions& options = {});
+
+    std::size_t num_partitions() const { return parts.size(); }
+    std::size_t num_vertices() const { return N; }
+    std::size_t num_hyperedges() const { return E; }
+
+private:
+    // Device state of one side (vertices or hyperedges) of one partition.
+    struct Side
+    {
+        std::size_t owned = 0;
+        std::size_t halo = 0;
+        std::vector<std::uint32_t> global_ids;       // owned entries in local order
+        std::vector<std::uint32_t> import_slots;     // boundary array slot of every halo entry
+        std::vector<std::uint32_t> import_staging;   // halo labels gathered on the host
+        std::size_t export_base = 0;                 // first boundary array slot written by this partition
+        std::size_t export_count = 0;
+
+        std::size_t* offsets_dev = nullptr;   // rows of the owned entries
+        std::uint32_t* indices_dev = nullptr; // local ids on the other side
+        std::uint32_t* labels_dev = nullptr;  // owned + halo entries
+        std::uint32_t* export_ids_dev = nullptr;
+        std::uint32_t* export_labels_dev = nullptr;
+    };
+
+    struct Partition
+    {
+        explicit Partition(const sycl::queue& queue);
+
+        sycl::queue q;
+        Side vertices;
+        Side hyperedges;
+        std::size_t nnz = 0;
+        std::uint32_t* scratch_dev = nullptr;   // sparse counting, one slot per local incidence
+        int* changed_dev = nullptr;
+        std::vector<sycl::event> kernels;       // events of the current run, for compute_ms
+    };
+
+    void build(const HypergraphSparse& H, std::vector<sycl::queue>& queues, const HypergraphPartition& partition);
+    void exchange(Side Partition::*side, std::vector<std::uint32_t>& boundary);
+
+    std::size_t N;
+    std::size_t E;
+    std::vector<Partition> parts;
+    std::vector<std::uint32_t> vertex_boundary;      // packed exported labels of all partitions
+    std::vector<std::uint32_t> hyperedge_boundary;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Philox4x32-10 counter-based generator (Salmon et al., SC'11). Every draw is a pure function of
+// (key, counter), so a stream can be rebuilt anywhere from its identifiers, on the host or in a kernel.
+struct Philox4x32
+{
+    std::uint32_t v[4];
+};
+
+inline Philox4x32 philox4x32(Philox4x32 ctr, std::uint32_t k0, std::uint32_t k1) {
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = std::uint64_t(0xD2511F53u) * ctr.v[0];
+        std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * ctr.v[2];
+        Philox4x32 next;
+        next.v[0] = static_cast<std::uint32_t>(p1 >> 32) ^ ctr.v[1] ^ k0;
+        next.v[1] = static_cast<std::uint32_t>(p1);
+        next.v[2] = static_cast<std::uint32_t>(p0 >> 32) ^ ctr.v[3] ^ k1;
+        next.v[3] = static_cast<std::uint32_t>(p0);
+        ctr = next;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    return ctr;
+}
+
+// Sequential draws from the stream identified by (seed, domain, id); the draw index is the counter.
+struct PhiloxStream
+{
+    std::uint32_t k0, k1;
+    std::uint32_t domain, id_lo, id_hi;
+    std::uint32_t counter = 0;
+    Philox4x32 block;
+    int used = 4;
+
+    PhiloxStream(std::uint64_t seed, std::uint32_t domain_, std::uint64_t id)
+        : k0(static_cast<std::uint32_t>(seed)), k1(static_cast<std::uint32_t>(seed >> 32)),
+          domain(domain_), id_lo(static_cast<std::uint32_t>(id)), id_hi(static_cast<std::uint32_t>(id >> 32)) {}
+
+    std::uint32_t next_u32() {
+        if (used == 4) {
+            Philox4x32 ctr = {{counter++, id_lo, id_hi, domain}};
+            block = philox4x32(ctr, k0, k1);
+            used = 0;
+        }
+        return block.v[used++];
+    }
+
+    std::uint64_t next_u64() {
+        std::uint64_t hi = next_u32();
+        return (hi << 32) | next_u32();
+    }
+
+    // Uniform double in [0, 1) with 53 random bits.
+    double next_unit() {
+        return static_cast<double>(next_u64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Seeding rule of the generators: vertex v is labeled with probability 0.4, with a label uniform over
+// 0..num_labels-1, and unlabeled (all ones) otherwise; drawn from the stream (seed, domain, v).
+inline std::uint32_t random_seed_label(std::uint64_t seed, std::uint32_t domain, std::uint64_t v, std::uint32_t num_labels) {
+    PhiloxStream rng(seed, domain, v);
+    return rng.next_unit() < 0.4 ? static_cast<std::uint32_t>(rng.next_unit() * num_labels) : std::numeric_limits<std::uint32_t>::max();
+}
+
+// Seed labels of N vertices under that rule, one seed set per value of seed (domain 0), for drivers that
+// reseed a loaded hypergraph.
+inline std::vector<std::uint32_t> random_seed_labels(std::size_t N, std::uint64_t seed, std::uint32_t num_labels) {
+    std::vector<std::uint32_t> labels(N);
+    for (std::size_t v = 0; v < N; ++v) labels[v] = random_seed_label(seed, 0, v, num_labels);
+    return labels;
+}
+
+#endif
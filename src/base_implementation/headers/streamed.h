@@ -0,0 +1,100 @@
+#ifndef STREAMED_H
+#define STREAMED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "engine.h"
+#include "hypergraph_io.h"
+#include "utils.h"
+
+// Host-side CSR/CSC arrays a streamed run reads its tiles from; they must outlive the runner.
+struct IncidenceSource
+{
+    std::size_t num_vertices = 0;
+    std::size_t num_hyperedges = 0;
+    std::size_t num_incidences = 0;
+    const std::size_t* vertex_offsets = nullptr;
+    const std::uint32_t* vertex_hyperedges = nullptr;
+    const std::size_t* hyperedge_offsets = nullptr;
+    const std::uint32_t* hyperedge_vertices = nullptr;
+};
+
+IncidenceSource incidence_source(const HypergraphSparse& H);
+// Reads the sections in place from the mapping; throws std::runtime_error unless the file has the CSR layout.
+IncidenceSource incidence_source(const MappedHypergraph& M);
+
+struct StreamedResult : LabelPropagationResult
+{
+    std::size_t tiles_per_iteration = 0;   // hyperedge (column block) tiles plus vertex (row block) tiles
+    std::uint64_t bytes_streamed = 0;      // incidence bytes copied to the device during the run
+};
+
+// Out-of-core label propagation: only the label arrays and the per-iteration changed flags stay on the
+// device. Each half-sweep streams the incidence structure of its side in tiles of consecutive rows
+// (CSC column blocks for the hyperedge phase, CSR row blocks for the vertex phase), at most
+// tile_incidences incidences each unless a single row is longer. Tiles rotate through two device
+// buffers: the host fills a pinned staging buffer and a copy queue uploads it while the compute queue
+// runs the previous tile. tile_incidences = 0 sizes the tiles to a quarter of the device memory.
+class StreamedLabelPropagation
+{
+public:
+    StreamedLabelPropagation(const IncidenceSource& source, std::size_t tile_incidences = 0);
+    StreamedLabelPropagation(const IncidenceSource& source, const sycl::queue& q, std::size_t tile_incidences = 0);
+    ~StreamedLabelPropagation();
+
+    StreamedLabelPropagation(const StreamedLabelPropagation&) = delete;
+    StreamedLabelPropagation& operator=(const StreamedLabelPropagation&) = delete;
+
+    // Same semantics as LabelPropagationEngine::run for max_iterations, convergence_check_interval and
+    // label_counting; rows are always processed one work-item each.
+    StreamedResult run(const std::vector<std::uint32_t>& seed_labels, const LabelPropagationOptions& options = {});
+
+    std::size_t num_vertices() const { return src.num_vertices; }
+    std::size_t num_hyperedges() const { return src.num_hyperedges; }
+    std::size_t num_incidences() const { return src.num_incidences; }
+    std::size_t tile_capacity() const { return max_tile_incidences; }
+
+private:
+    // Rows [first_row, last_row) of one side.
+    struct Tile
+    {
+        std::size_t first_row;
+        std::size_t last_row;
+    };
+
+    // One of the two buffers tiles rotate through.
+    struct TileBuffer
+    {
+        std::size_t* offsets_host = nullptr;   // pinned staging
+        std::uint32_t* indices_host = nullptr;
+        std::size_t* offsets_dev = nullptr;
+        std::uint32_t* indices_dev = nullptr;
+        sycl::event uploaded;   // copy of the tile now in the buffer
+        sycl::event consumed;   // kernel that last read the buffer
+    };
+
+    std::vector<Tile> make_tiles(const std::size_t* offsets, std::size_t rows, std::size_t budget) const;
+    void stream_side(const std::vector<Tile>& tiles, const std::size_t* offsets, const std::uint32_t* indices,
+                     const std::uint32_t* in_labels, std::uint32_t* out_labels, int* changed_flag, bool sparse,
+                     StreamedResult& result);
+
+    IncidenceSource src;
+    sycl::queue q;        // compute, in-order
+    sycl::queue copy_q;   // uploads, in-order, same context
+    std::vector<Tile> hyperedge_tiles;
+    std::vector<Tile> vertex_tiles;
+    std::size_t max_tile_rows = 0;
+    std::size_t max_tile_incidences = 0;
+
+    TileBuffer buffers[2];
+    std::size_t next_buffer = 0;
+    std::uint32_t* vlabels_dev;
+    std::uint32_t* helabels_dev;
+    std::uint32_t* scratch_dev = nullptr;   // sparse counting, allocated by the first sparse run
+    int* changed_dev = nullptr;
+    std::size_t changed_capacity = 0;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One profiled device command. Times are the command start and end from SYCL event profiling, in
+// nanoseconds relative to the first recorded command.
+struct TraceEvent
+{
+    std::string name;                // "h2d", "transpose", "hyperedge_phase", "vertex_phase", "d2h"
+    std::size_t iteration;           // sweep index for the two phases, 0 otherwise
+    std::uint64_t start_ns;
+    std::uint64_t end_ns;
+};
+
+// Labels that changed in one sweep. Every queued sweep is listed, including those queued after
+// convergence in the last batch (they change nothing).
+struct IterationChanges
+{
+    std::uint32_t hyperedges;
+    std::uint32_t vertices;
+};
+
+// Filled by find_communities / find_communities_transpose when a trace is passed; they then use a
+// profiling queue and count changed labels instead of only raising a flag. Without a trace neither
+// happens, so collection costs nothing unless it was asked for.
+struct PropagationTrace
+{
+    std::vector<TraceEvent> events;
+    std::vector<IterationChanges> iterations;
+
+    // Chrome trace (chrome://tracing, Perfetto): one complete event per command plus counter tracks
+    // with the changed hyperedges and vertices at the end of each phase.
+    void write_chrome_trace(const std::string& path) const;
+    // One row per command: name,iteration,start_ns,duration_ns,changed (changed only for the two phases).
+    void write_csv(const std::string& path) const;
+};
+
+#endif
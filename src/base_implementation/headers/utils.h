@@ -1,21 +1,192 @@
 #ifndef HYPERGRAPHNOTSPARSE_H
 #define HYPERGRAPHNOTSPARSE_H
 
+#include <algorithm>
 #include <vector>
 #include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <utility>
 
-struct HypergraphNotSparse
+// Where an IncidenceMatrix keeps its entries. The default (both empty) is ordinary host memory; SYCL
+// callers can plug in USM host or shared memory (usm_incidence_allocation in algorithms.h) so the
+// kernels upload the matrix without staging, or read it in place.
+struct IncidenceAllocation
+{
+    std::function<void*(std::size_t bytes)> allocate;
+    std::function<void(void*)> release;
+};
+
+// rows x cols entries in one contiguous row-major buffer, so the dense kernels can upload (or read) it
+// as is. M[v][e] addresses entry (v, e). Copies use the same kind of memory as the original.
+template <typename Incidence>
+class IncidenceMatrix
+{
+public:
+    IncidenceMatrix() = default;
+    IncidenceMatrix(const IncidenceMatrix& other) {
+        resize(other.num_rows, other.num_cols, other.allocation);
+        std::copy(other.values, other.values + size(), values);
+    }
+    IncidenceMatrix(IncidenceMatrix&& other) noexcept { swap(other); }
+    IncidenceMatrix& operator=(IncidenceMatrix other) {
+        swap(other);
+        return *this;
+    }
+    ~IncidenceMatrix() { release_storage(); }
+
+    // Replaces the contents with rows x cols zeros in memory from alloc.
+    void resize(std::size_t rows, std::size_t cols, const IncidenceAllocation& alloc = {}) {
+        release_storage();
+        allocation = alloc;
+        const std::size_t bytes = rows * cols * sizeof(Incidence);
+        if (bytes != 0) {
+            // calloc hands out zeroed pages lazily, so untouched parts of a large matrix cost nothing up front.
+            void* p = allocation.allocate ? allocation.allocate(bytes) : std::calloc(rows * cols, sizeof(Incidence));
+            if (p == nullptr) throw std::bad_alloc();
+            values = static_cast<Incidence*>(p);
+            if (allocation.allocate) std::fill(values, values + rows * cols, Incidence(0));
+        }
+        num_rows = rows;
+        num_cols = cols;
+    }
+
+    Incidence* operator[](std::size_t row) { return values + row * num_cols; }
+    const Incidence* operator[](std::size_t row) const { return values + row * num_cols; }
+
+    Incidence* data() { return values; }
+    const Incidence* data() const { return values; }
+    std::size_t rows() const { return num_rows; }
+    std::size_t cols() const { return num_cols; }
+    std::size_t size() const { return num_rows * num_cols; }
+    const IncidenceAllocation& memory() const { return allocation; }
+
+    void swap(IncidenceMatrix& other) noexcept {
+        std::swap(values, other.values);
+        std::swap(num_rows, other.num_rows);
+        std::swap(num_cols, other.num_cols);
+        std::swap(allocation, other.allocation);
+    }
+
+private:
+    void release_storage() {
+        if (values != nullptr) {
+            if (allocation.release) allocation.release(values);
+            else std::free(values);
+        }
+        values = nullptr;
+        num_rows = num_cols = 0;
+    }
+
+    Incidence* values = nullptr;
+    std::size_t num_rows = 0;
+    std::size_t num_cols = 0;
+    IncidenceAllocation allocation;
+};
+
+// Dense incidence matrix, row v holding one Incidence entry (0 or 1) per hyperedge. The all-ones value
+// of Label marks an unlabeled vertex or hyperedge. Narrow element types cut the bandwidth of the dense
+// kernels; HypergraphNotSparse is the 32-bit form every loader and converter works with.
+template <typename Label, typename Incidence>
+struct BasicHypergraphNotSparse
 {
     std::size_t num_vertices;
     std::size_t num_hyperedges;
     
-    std::vector<std::vector<std::uint32_t>> incidence_matrix;
+    IncidenceMatrix<Incidence> incidence_matrix;
+
+    std::vector<Label> vertex_labels;
+    std::vector<Label> hyperedge_labels;
+};
+
+using HypergraphNotSparse = BasicHypergraphNotSparse<std::uint32_t, std::uint32_t>;
+
+struct HypergraphSparse
+{
+    std::size_t num_vertices;
+    std::size_t num_hyperedges;
+
+    // CSR: incident hyperedges of vertex v are vertex_hyperedges[vertex_offsets[v] .. vertex_offsets[v + 1])
+    std::vector<std::size_t> vertex_offsets;
+    std::vector<std::uint32_t> vertex_hyperedges;
+
+    // CSC: incident vertices of hyperedge e are hyperedge_vertices[hyperedge_offsets[e] .. hyperedge_offsets[e + 1])
+    std::vector<std::size_t> hyperedge_offsets;
+    std::vector<std::uint32_t> hyperedge_vertices;
+
+    std::vector<std::uint32_t> vertex_labels;
+    std::vector<std::uint32_t> hyperedge_labels;
+
+    std::size_t num_incidences() const { return vertex_hyperedges.size(); }
+};
+
+// Rows are padded to a multiple of BitsetRowAlignWords words so every row starts on a 64-byte boundary.
+constexpr std::size_t BitsetWordBits = 64;
+constexpr std::size_t BitsetRowAlignWords = 8;
+
+inline std::size_t bitset_words_per_row(std::size_t bits) {
+    std::size_t words = (bits + BitsetWordBits - 1) / BitsetWordBits;
+    return (words + BitsetRowAlignWords - 1) / BitsetRowAlignWords * BitsetRowAlignWords;
+}
+
+struct HypergraphBitset
+{
+    std::size_t num_vertices;
+    std::size_t num_hyperedges;
+    std::size_t words_per_row;
+
+    // Row v holds one bit per hyperedge: bit (e % 64) of word incidence_bits[v * words_per_row + e / 64].
+    std::vector<std::uint64_t> incidence_bits;
 
     std::vector<std::uint32_t> vertex_labels;
     std::vector<std::uint32_t> hyperedge_labels;
 };
 
-HypergraphNotSparse generate_hypergraph(std::size_t N, std::size_t E, double p);
+// Instantiated for uint8_t, uint16_t and uint32_t labels and incidences. The incidence matrix is written
+// in place into memory from allocation.
+template <typename Label = std::uint32_t, typename Incidence = std::uint32_t>
+BasicHypergraphNotSparse<Label, Incidence> generate_hypergraph(std::size_t N, std::size_t E, double p, const IncidenceAllocation& allocation = {});
+// generate_hypergraph_parallel on a single thread with the default seed.
+HypergraphSparse generate_hypergraph_sparse(std::size_t N, std::size_t E, double p);
+// O(nnz) generation on num_threads host threads (0 = all); the output does not depend on num_threads.
+HypergraphSparse generate_hypergraph_parallel(std::size_t N, std::size_t E, double p, std::uint64_t seed = 42, unsigned num_threads = 0);
+
+HypergraphSparse to_sparse(const HypergraphNotSparse& H);
+void build_hyperedge_index(HypergraphSparse& H);
+// Builds the column index of a (row_offsets, row_indices) structure on up to num_threads threads.
+// Every column lists its rows in increasing order, so the result does not depend on the thread count.
+void transpose_incidence_index(const std::vector<std::size_t>& row_offsets, const std::vector<std::uint32_t>& row_indices,
+                               std::size_t num_cols, unsigned num_threads,
+                               std::vector<std::size_t>& col_offsets, std::vector<std::uint32_t>& col_indices);
+HypergraphBitset to_bitset(const HypergraphNotSparse& H);
+// Dense and bitset forms of a CSR hypergraph; apart from zeroing the matrix the cost is O(nnz).
+HypergraphNotSparse to_dense(const HypergraphSparse& S, const IncidenceAllocation& allocation = {});
+HypergraphBitset to_bitset(const HypergraphSparse& S);
+
+// Copies labels into another label type, mapping the unlabeled marker to the unlabeled marker.
+// Every other label must be representable in To.
+template <typename To, typename From>
+std::vector<To> convert_labels(const std::vector<From>& labels) {
+    std::vector<To> out(labels.size());
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        out[i] = labels[i] == std::numeric_limits<From>::max() ? std::numeric_limits<To>::max() : static_cast<To>(labels[i]);
+    }
+    return out;
+}
+
+template <typename Label, typename Incidence, typename FromLabel, typename FromIncidence>
+BasicHypergraphNotSparse<Label, Incidence> convert_hypergraph(const BasicHypergraphNotSparse<FromLabel, FromIncidence>& H) {
+    BasicHypergraphNotSparse<Label, Incidence> out;
+    out.num_vertices = H.num_vertices;
+    out.num_hyperedges = H.num_hyperedges;
+    out.incidence_matrix.resize(H.num_vertices, H.num_hyperedges, H.incidence_matrix.memory());
+    std::copy(H.incidence_matrix.data(), H.incidence_matrix.data() + H.incidence_matrix.size(), out.incidence_matrix.data());
+    out.vertex_labels = convert_labels<Label>(H.vertex_labels);
+    out.hyperedge_labels = convert_labels<Label>(H.hyperedge_labels);
+    return out;
+}
 
 #endif
 
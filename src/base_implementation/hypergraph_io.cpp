@@ -0,0 +1,646 @@
+#include "../base_implementation/headers/hypergraph_io.h"
+#include "../base_implementation/headers/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "offsets are stored as uint64_t");
+
+static std::uint64_t align_up(std::uint64_t offset) {
+    return (offset + HypergraphFileAlignment - 1) / HypergraphFileAlignment * HypergraphFileAlignment;
+}
+
+HypergraphFileSections hypergraph_file_sections(const HypergraphFileHeader& header) {
+    const std::uint64_t N = header.num_vertices;
+    const std::uint64_t E = header.num_hyperedges;
+    const std::uint64_t NNZ = header.num_incidences;
+
+    HypergraphFileSections s = {};
+    s.vertex_labels = sizeof(HypergraphFileHeader);
+    s.hyperedge_labels = align_up(s.vertex_labels + N * header.label_width);
+    std::uint64_t payload = align_up(s.hyperedge_labels + E * header.label_width);
+
+    switch (static_cast<HypergraphLayout>(header.layout)) {
+    case HypergraphLayout::Dense:
+        s.dense_incidence = payload;
+        s.file_size = payload + N * E;
+        break;
+    case HypergraphLayout::Bitset:
+        s.incidence_bits = payload;
+        s.file_size = payload + N * header.words_per_row * sizeof(std::uint64_t);
+        break;
+    case HypergraphLayout::CSR:
+        s.vertex_offsets = payload;
+        s.vertex_hyperedges = align_up(s.vertex_offsets + (N + 1) * sizeof(std::uint64_t));
+        s.hyperedge_offsets = align_up(s.vertex_hyperedges + NNZ * sizeof(std::uint32_t));
+        s.hyperedge_vertices = align_up(s.hyperedge_offsets + (E + 1) * sizeof(std::uint64_t));
+        s.file_size = s.hyperedge_vertices + NNZ * sizeof(std::uint32_t);
+        break;
+    default:
+        throw std::runtime_error("unknown hypergraph layout " + std::to_string(header.layout));
+    }
+    return s;
+}
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file_handle, &file_size);
+    length = static_cast<std::size_t>(file_size.QuadPart);
+    if (length == 0) return;
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle != nullptr) {
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (bytes == nullptr) {
+        if (mapping_handle != nullptr) CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        throw std::runtime_error("cannot map " + path);
+    }
+#else
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    fstat(fd, &st);
+    length = static_cast<std::size_t>(st.st_size);
+    if (length == 0) return;
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("cannot map " + path);
+    }
+    madvise(addr, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const unsigned char*>(addr);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (bytes != nullptr) UnmapViewOfFile(bytes);
+    if (mapping_handle != nullptr) CloseHandle(mapping_handle);
+    if (file_handle != nullptr) CloseHandle(file_handle);
+#else
+    if (bytes != nullptr) munmap(const_cast<unsigned char*>(bytes), length);
+    if (fd >= 0) close(fd);
+#endif
+}
+
+MappedHypergraph::MappedHypergraph(const std::string& path) : file(path) {
+    if (file.size() < sizeof(HypergraphFileHeader) || std::memcmp(header().magic, HypergraphFileMagic, sizeof(HypergraphFileMagic)) != 0) {
+        throw std::runtime_error(path + " is not a hypergraph file");
+    }
+    if (header().version != HypergraphFileVersion) {
+        throw std::runtime_error(path + ": unsupported version " + std::to_string(header().version));
+    }
+    offsets = hypergraph_file_sections(header());
+    if (offsets.file_size > file.size()) {
+        throw std::runtime_error(path + " is truncated");
+    }
+}
+
+template <typename T>
+static void widen_labels(const unsigned char* src, std::size_t count, std::vector<std::uint32_t>& out) {
+    out.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        out[i] = value == std::numeric_limits<T>::max() ? std::numeric_limits<std::uint32_t>::max() : value;
+    }
+}
+
+static void read_labels(const unsigned char* src, std::size_t count, std::uint32_t width, std::vector<std::uint32_t>& out) {
+    switch (width) {
+    case 1: widen_labels<std::uint8_t>(src, count, out); break;
+    case 2: widen_labels<std::uint16_t>(src, count, out); break;
+    case 4: widen_labels<std::uint32_t>(src, count, out); break;
+    default: throw std::runtime_error("unsupported label width " + std::to_string(width));
+    }
+}
+
+void MappedHypergraph::read_vertex_labels(std::vector<std::uint32_t>& out) const {
+    read_labels(file.data() + offsets.vertex_labels, header().num_vertices, header().label_width, out);
+}
+
+void MappedHypergraph::read_hyperedge_labels(std::vector<std::uint32_t>& out) const {
+    read_labels(file.data() + offsets.hyperedge_labels, header().num_hyperedges, header().label_width, out);
+}
+
+static HypergraphFileHeader make_header(HypergraphLayout layout, std::size_t N, std::size_t E, std::size_t nnz, std::size_t words_per_row) {
+    HypergraphFileHeader header = {};
+    std::memcpy(header.magic, HypergraphFileMagic, sizeof(HypergraphFileMagic));
+    header.version = HypergraphFileVersion;
+    header.layout = static_cast<std::uint32_t>(layout);
+    header.num_vertices = N;
+    header.num_hyperedges = E;
+    header.num_incidences = nnz;
+    header.words_per_row = words_per_row;
+    header.label_width = sizeof(std::uint32_t);
+    return header;
+}
+
+// Appends to a file while keeping track of the position, so sections can be padded to their offsets.
+struct SectionWriter
+{
+    std::ofstream file;
+    std::uint64_t position = 0;
+
+    explicit SectionWriter(const std::string& path) : file(path, std::ios::binary | std::ios::trunc) {
+        if (!file) throw std::runtime_error("cannot create " + path);
+    }
+
+    void write(const void* src, std::uint64_t bytes) {
+        file.write(static_cast<const char*>(src), static_cast<std::streamsize>(bytes));
+        position += bytes;
+    }
+
+    void seek(std::uint64_t offset) {
+        static const char zeros[HypergraphFileAlignment] = {};
+        while (position < offset) write(zeros, std::min<std::uint64_t>(offset - position, sizeof(zeros)));
+    }
+
+    void finish(const std::string& path) {
+        file.close();
+        if (!file) throw std::runtime_error("error writing " + path);
+    }
+};
+
+static void write_header_and_labels(SectionWriter& out, const HypergraphFileHeader& header, const HypergraphFileSections& s,
+                                    const std::vector<std::uint32_t>& vertex_labels, const std::vector<std::uint32_t>& hyperedge_labels) {
+    out.write(&header, sizeof(header));
+    out.seek(s.vertex_labels);
+    out.write(vertex_labels.data(), vertex_labels.size() * sizeof(std::uint32_t));
+    out.seek(s.hyperedge_labels);
+    out.write(hyperedge_labels.data(), hyperedge_labels.size() * sizeof(std::uint32_t));
+}
+
+void save_hypergraph(const HypergraphNotSparse& H, const std::string& path) {
+    const std::size_t nnz = static_cast<std::size_t>(std::count(H.incidence_matrix.data(), H.incidence_matrix.data() + H.incidence_matrix.size(), 1u));
+
+    HypergraphFileHeader header = make_header(HypergraphLayout::Dense, H.num_vertices, H.num_hyperedges, nnz, 0);
+    HypergraphFileSections s = hypergraph_file_sections(header);
+
+    SectionWriter out(path);
+    write_header_and_labels(out, header, s, H.vertex_labels, H.hyperedge_labels);
+    out.seek(s.dense_incidence);
+    std::vector<std::uint8_t> row_bytes(H.num_hyperedges);
+    for (std::size_t v = 0; v < H.num_vertices; ++v) {
+        std::copy(H.incidence_matrix[v], H.incidence_matrix[v] + H.num_hyperedges, row_bytes.begin());
+        out.write(row_bytes.data(), row_bytes.size());
+    }
+    out.finish(path);
+}
+
+void save_hypergraph(const HypergraphSparse& H, const std::string& path) {
+    HypergraphFileHeader header = make_header(HypergraphLayout::CSR, H.num_vertices, H.num_hyperedges, H.num_incidences(), 0);
+    HypergraphFileSections s = hypergraph_file_sections(header);
+
+    SectionWriter out(path);
+    write_header_and_labels(out, header, s, H.vertex_labels, H.hyperedge_labels);
+    out.seek(s.vertex_offsets);
+    out.write(H.vertex_offsets.data(), H.vertex_offsets.size() * sizeof(std::uint64_t));
+    out.seek(s.vertex_hyperedges);
+    out.write(H.vertex_hyperedges.data(), H.vertex_hyperedges.size() * sizeof(std::uint32_t));
+    out.seek(s.hyperedge_offsets);
+    out.write(H.hyperedge_offsets.data(), H.hyperedge_offsets.size() * sizeof(std::uint64_t));
+    out.seek(s.hyperedge_vertices);
+    out.write(H.hyperedge_vertices.data(), H.hyperedge_vertices.size() * sizeof(std::uint32_t));
+    out.finish(path);
+}
+
+void save_hypergraph(const HypergraphBitset& H, const std::string& path) {
+    std::size_t nnz = 0;
+    for (std::uint64_t word : H.incidence_bits)
+        for (; word != 0; word &= word - 1) nnz++;
+
+    HypergraphFileHeader header = make_header(HypergraphLayout::Bitset, H.num_vertices, H.num_hyperedges, nnz, H.words_per_row);
+    HypergraphFileSections s = hypergraph_file_sections(header);
+
+    SectionWriter out(path);
+    write_header_and_labels(out, header, s, H.vertex_labels, H.hyperedge_labels);
+    out.seek(s.incidence_bits);
+    out.write(H.incidence_bits.data(), H.incidence_bits.size() * sizeof(std::uint64_t));
+    out.finish(path);
+}
+
+// Calls f(v, e) for every incidence of the mapped file, vertex by vertex, whatever its layout.
+template <typename F>
+static void for_each_incidence(const MappedHypergraph& M, F f) {
+    const std::size_t N = M.header().num_vertices;
+    const std::size_t E = M.header().num_hyperedges;
+
+    switch (M.layout()) {
+    case HypergraphLayout::Dense: {
+        const std::uint8_t* dense = M.dense_incidence();
+        for (std::size_t v = 0; v < N; ++v)
+            for (std::size_t e = 0; e < E; ++e)
+                if (dense[v * E + e] == 1) f(v, e);
+        break;
+    }
+    case HypergraphLayout::Bitset: {
+        const std::size_t words_per_row = M.header().words_per_row;
+        const std::uint64_t* bits = M.incidence_bits();
+        for (std::size_t v = 0; v < N; ++v)
+            for (std::size_t w = 0; w < words_per_row; ++w)
+                for (std::uint64_t word = bits[v * words_per_row + w]; word != 0; word &= word - 1) {
+                    std::size_t b = 0;
+                    while (((word >> b) & 1) == 0) b++;
+                    f(v, w * BitsetWordBits + b);
+                }
+        break;
+    }
+    case HypergraphLayout::CSR: {
+        const std::uint64_t* offsets = M.vertex_offsets();
+        const std::uint32_t* hyperedges = M.vertex_hyperedges();
+        for (std::size_t v = 0; v < N; ++v)
+            for (std::uint64_t k = offsets[v]; k < offsets[v + 1]; ++k) f(v, hyperedges[k]);
+        break;
+    }
+    }
+}
+
+static bool is_text_hypergraph(const std::string& path) {
+    auto ends_with = [&](const char* ext) {
+        std::size_t n = std::strlen(ext);
+        return path.size() >= n && path.compare(path.size() - n, n, ext) == 0;
+    };
+    return ends_with(".hgr") || ends_with(".mtx");
+}
+
+static HypergraphSparse read_text_hypergraph(const std::string& path) {
+    const std::size_t n = path.size();
+    return path.compare(n - 4, 4, ".hgr") == 0 ? read_hmetis(path) : read_matrix_market(path);
+}
+
+HypergraphNotSparse load_hypergraph_dense(const std::string& path) {
+    if (is_text_hypergraph(path)) return to_dense(read_text_hypergraph(path));
+
+    MappedHypergraph M(path);
+
+    HypergraphNotSparse H;
+    H.num_vertices = M.header().num_vertices;
+    H.num_hyperedges = M.header().num_hyperedges;
+    H.incidence_matrix.resize(H.num_vertices, H.num_hyperedges);
+
+    if (M.layout() == HypergraphLayout::Dense) {
+        const std::uint8_t* dense = M.dense_incidence();
+        std::copy(dense, dense + H.incidence_matrix.size(), H.incidence_matrix.data());
+    } else {
+        for_each_incidence(M, [&](std::size_t v, std::size_t e) { H.incidence_matrix[v][e] = 1; });
+    }
+
+    M.read_vertex_labels(H.vertex_labels);
+    M.read_hyperedge_labels(H.hyperedge_labels);
+    return H;
+}
+
+HypergraphSparse load_hypergraph_sparse(const std::string& path) {
+    if (is_text_hypergraph(path)) return read_text_hypergraph(path);
+
+    MappedHypergraph M(path);
+
+    HypergraphSparse H;
+    H.num_vertices = M.header().num_vertices;
+    H.num_hyperedges = M.header().num_hyperedges;
+
+    if (M.layout() == HypergraphLayout::CSR) {
+        const std::size_t nnz = M.header().num_incidences;
+        H.vertex_offsets.assign(M.vertex_offsets(), M.vertex_offsets() + H.num_vertices + 1);
+        H.vertex_hyperedges.assign(M.vertex_hyperedges(), M.vertex_hyperedges() + nnz);
+        H.hyperedge_offsets.assign(M.hyperedge_offsets(), M.hyperedge_offsets() + H.num_hyperedges + 1);
+        H.hyperedge_vertices.assign(M.hyperedge_vertices(), M.hyperedge_vertices() + nnz);
+    } else {
+        H.vertex_offsets.assign(H.num_vertices + 1, 0);
+        H.vertex_hyperedges.reserve(M.header().num_incidences);
+        for_each_incidence(M, [&](std::size_t v, std::size_t e) {
+            H.vertex_hyperedges.push_back(static_cast<std::uint32_t>(e));
+            H.vertex_offsets[v + 1] = H.vertex_hyperedges.size();
+        });
+        for (std::size_t v = 0; v < H.num_vertices; ++v)
+            H.vertex_offsets[v + 1] = std::max(H.vertex_offsets[v + 1], H.vertex_offsets[v]);
+        build_hyperedge_index(H);
+    }
+
+    M.read_vertex_labels(H.vertex_labels);
+    M.read_hyperedge_labels(H.hyperedge_labels);
+    return H;
+}
+
+HypergraphBitset load_hypergraph_bitset(const std::string& path) {
+    if (is_text_hypergraph(path)) return to_bitset(read_text_hypergraph(path));
+
+    MappedHypergraph M(path);
+
+    HypergraphBitset H;
+    H.num_vertices = M.header().num_vertices;
+    H.num_hyperedges = M.header().num_hyperedges;
+    H.words_per_row = bitset_words_per_row(H.num_hyperedges);
+
+    if (M.layout() == HypergraphLayout::Bitset && M.header().words_per_row == H.words_per_row) {
+        H.incidence_bits.assign(M.incidence_bits(), M.incidence_bits() + H.num_vertices * H.words_per_row);
+    } else {
+        H.incidence_bits.assign(H.num_vertices * H.words_per_row, 0);
+        for_each_incidence(M, [&](std::size_t v, std::size_t e) {
+            H.incidence_bits[v * H.words_per_row + e / BitsetWordBits] |= std::uint64_t(1) << (e % BitsetWordBits);
+        });
+    }
+
+    M.read_vertex_labels(H.vertex_labels);
+    M.read_hyperedge_labels(H.hyperedge_labels);
+    return H;
+}
+
+// ---- Text formats ----
+
+static bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static const char* line_end(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    return nl != nullptr ? nl : end;
+}
+
+// True for lines holding no data: blank lines and '%' comments (both formats use '%').
+static bool is_skipped_line(const char* p, const char* eol) {
+    while (p < eol && is_blank(*p)) ++p;
+    return p == eol || *p == '%';
+}
+
+// Skips separators and reads the next whitespace-delimited token of the line; false at end of line.
+static bool next_token(const char*& p, const char* eol, const char*& token, const char*& token_end) {
+    while (p < eol && is_blank(*p)) ++p;
+    if (p == eol) return false;
+    token = p;
+    while (p < eol && !is_blank(*p)) ++p;
+    token_end = p;
+    return true;
+}
+
+static bool next_uint(const char*& p, const char* eol, std::uint64_t& value) {
+    const char* token;
+    const char* token_end;
+    if (!next_token(p, eol, token, token_end)) return false;
+    value = 0;
+    for (const char* c = token; c < token_end; ++c) {
+        if (*c < '0' || *c > '9') throw std::runtime_error("expected an unsigned integer, found '" + std::string(token, token_end) + "'");
+        value = value * 10 + static_cast<std::uint64_t>(*c - '0');
+    }
+    return true;
+}
+
+// Returns the first data line at or after p, or end.
+static const char* skip_to_data(const char* p, const char* end) {
+    while (p < end) {
+        const char* eol = line_end(p, end);
+        if (!is_skipped_line(p, eol)) return p;
+        p = eol + 1;
+    }
+    return end;
+}
+
+// Splits [begin, end) into num_chunks ranges whose boundaries fall on line starts.
+static std::vector<const char*> line_chunks(const char* begin, const char* end, unsigned num_chunks) {
+    std::vector<const char*> bounds(num_chunks + 1, end);
+    bounds[0] = begin;
+    std::size_t step = static_cast<std::size_t>(end - begin) / num_chunks;
+    for (unsigned c = 1; c < num_chunks; ++c) {
+        const char* p = std::max(bounds[c - 1], begin + c * step);
+        if (p > begin && p < end && p[-1] != '\n') p = std::min(end, line_end(p, end) + 1);
+        bounds[c] = p;
+    }
+    return bounds;
+}
+
+// Runs f(chunk) for every chunk on its own thread and rethrows the first exception.
+template <typename F>
+static void for_each_chunk(unsigned num_chunks, F f) {
+    std::vector<std::exception_ptr> errors(num_chunks);
+    parallel_chunks(num_chunks, num_chunks, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t c = begin; c < end; ++c) {
+            try {
+                f(c);
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        }
+    });
+    for (auto& error : errors)
+        if (error) std::rethrow_exception(error);
+}
+
+static void unlabeled(HypergraphSparse& H) {
+    H.vertex_labels.assign(H.num_vertices, std::numeric_limits<std::uint32_t>::max());
+    H.hyperedge_labels.assign(H.num_hyperedges, std::numeric_limits<std::uint32_t>::max());
+}
+
+HypergraphSparse read_hmetis(const std::string& path, unsigned num_threads) {
+    num_threads = resolve_num_threads(num_threads);
+    MappedFile file(path);
+    const char* begin = reinterpret_cast<const char*>(file.data());
+    const char* end = begin + file.size();
+
+    const char* p = skip_to_data(begin, end);
+    const char* eol = line_end(p, end);
+    std::uint64_t E = 0, N = 0, fmt = 0;
+    if (!next_uint(p, eol, E) || !next_uint(p, eol, N)) throw std::runtime_error(path + ": missing hMETIS header");
+    next_uint(p, eol, fmt);
+    const bool weighted_hyperedges = fmt % 10 == 1;
+    const char* body = std::min(end, eol + 1);
+
+    // Pass 1: data lines per chunk, so every chunk knows the id of its first hyperedge.
+    std::vector<const char*> bounds = line_chunks(body, end, num_threads);
+    std::vector<std::size_t> first_line(num_threads + 1, 0);
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        std::size_t lines = 0;
+        for (const char* q = bounds[c]; q < bounds[c + 1];) {
+            const char* q_eol = line_end(q, end);
+            if (!is_skipped_line(q, q_eol)) lines++;
+            q = q_eol + 1;
+        }
+        first_line[c + 1] = lines;
+    });
+    for (unsigned c = 0; c < num_threads; ++c) first_line[c + 1] += first_line[c];
+    if (first_line[num_threads] < E) throw std::runtime_error(path + ": expected " + std::to_string(E) + " hyperedges");
+
+    // Pass 2: each chunk parses its hyperedge lines into sorted, duplicate-free vertex lists.
+    HypergraphSparse H;
+    H.num_vertices = N;
+    H.num_hyperedges = E;
+    H.hyperedge_offsets.assign(E + 1, 0);
+    std::vector<std::vector<std::uint32_t>> chunk_vertices(num_threads);
+
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        std::size_t e = first_line[c];
+        std::vector<std::uint32_t>& out = chunk_vertices[c];
+        for (const char* q = bounds[c]; q < bounds[c + 1] && e < E;) {
+            const char* q_eol = line_end(q, end);
+            if (is_skipped_line(q, q_eol)) {
+                q = q_eol + 1;
+                continue;
+            }
+            std::size_t start = out.size();
+            std::uint64_t id;
+            if (weighted_hyperedges) next_uint(q, q_eol, id);
+            while (next_uint(q, q_eol, id)) {
+                if (id == 0 || id > N) throw std::runtime_error(path + ": vertex " + std::to_string(id) + " out of range");
+                out.push_back(static_cast<std::uint32_t>(id - 1));
+            }
+            std::sort(out.begin() + start, out.end());
+            out.erase(std::unique(out.begin() + start, out.end()), out.end());
+            H.hyperedge_offsets[e + 1] = out.size() - start;
+            e++;
+            q = q_eol + 1;
+        }
+    });
+
+    for (std::size_t e = 0; e < E; ++e) H.hyperedge_offsets[e + 1] += H.hyperedge_offsets[e];
+    H.hyperedge_vertices.resize(H.hyperedge_offsets[E]);
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        if (first_line[c] >= E) return;
+        std::copy(chunk_vertices[c].begin(), chunk_vertices[c].end(), H.hyperedge_vertices.begin() + H.hyperedge_offsets[first_line[c]]);
+        std::vector<std::uint32_t>().swap(chunk_vertices[c]);
+    });
+
+    transpose_incidence_index(H.hyperedge_offsets, H.hyperedge_vertices, N, num_threads, H.vertex_offsets, H.vertex_hyperedges);
+    unlabeled(H);
+    return H;
+}
+
+static bool is_zero_value(const char* token, const char* token_end) {
+    for (const char* c = token; c < token_end; ++c) {
+        if (*c == 'e' || *c == 'E') break;
+        if (*c != '0' && *c != '.' && *c != '+' && *c != '-') return false;
+    }
+    return true;
+}
+
+HypergraphSparse read_matrix_market(const std::string& path, unsigned num_threads) {
+    num_threads = resolve_num_threads(num_threads);
+    MappedFile file(path);
+    const char* begin = reinterpret_cast<const char*>(file.data());
+    const char* end = begin + file.size();
+
+    const char* banner_end = line_end(begin, end);
+    std::string banner(begin, banner_end);
+    for (char& ch : banner) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    if (banner.compare(0, 14, "%%matrixmarket") != 0 || banner.find("coordinate") == std::string::npos)
+        throw std::runtime_error(path + ": not a MatrixMarket coordinate file");
+    if (banner.find("general") == std::string::npos)
+        throw std::runtime_error(path + ": only general (non-symmetric) incidence matrices are supported");
+    const bool has_values = banner.find("pattern") == std::string::npos;
+
+    const char* p = skip_to_data(begin, end);
+    const char* eol = line_end(p, end);
+    std::uint64_t N = 0, E = 0, entries = 0;
+    if (!next_uint(p, eol, N) || !next_uint(p, eol, E) || !next_uint(p, eol, entries))
+        throw std::runtime_error(path + ": missing MatrixMarket size line");
+    const char* body = std::min(end, eol + 1);
+
+    // Each chunk collects its (vertex, hyperedge) entries; duplicates are removed once rows are built.
+    std::vector<const char*> bounds = line_chunks(body, end, num_threads);
+    std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> chunk_entries(num_threads);
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        auto& out = chunk_entries[c];
+        for (const char* q = bounds[c]; q < bounds[c + 1];) {
+            const char* q_eol = line_end(q, end);
+            if (!is_skipped_line(q, q_eol)) {
+                std::uint64_t v = 0, e = 0;
+                next_uint(q, q_eol, v);
+                if (!next_uint(q, q_eol, e)) throw std::runtime_error(path + ": incomplete entry");
+                if (v == 0 || v > N || e == 0 || e > E) throw std::runtime_error(path + ": entry out of range");
+                const char* token;
+                const char* token_end;
+                if (!has_values || !next_token(q, q_eol, token, token_end) || !is_zero_value(token, token_end))
+                    out.emplace_back(static_cast<std::uint32_t>(v - 1), static_cast<std::uint32_t>(e - 1));
+            }
+            q = q_eol + 1;
+        }
+    });
+
+    HypergraphSparse H;
+    H.num_vertices = N;
+    H.num_hyperedges = E;
+
+    std::unique_ptr<std::atomic<std::size_t>[]> cursor(new std::atomic<std::size_t>[N]);
+    for (std::size_t v = 0; v < N; ++v) cursor[v].store(0, std::memory_order_relaxed);
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        for (const auto& ve : chunk_entries[c]) cursor[ve.first].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<std::size_t> raw_offsets(N + 1, 0);
+    for (std::size_t v = 0; v < N; ++v) {
+        raw_offsets[v + 1] = raw_offsets[v] + cursor[v].load(std::memory_order_relaxed);
+        cursor[v].store(raw_offsets[v], std::memory_order_relaxed);
+    }
+    std::vector<std::uint32_t> raw_hyperedges(raw_offsets[N]);
+    for_each_chunk(num_threads, [&](std::size_t c) {
+        for (const auto& ve : chunk_entries[c]) raw_hyperedges[cursor[ve.first].fetch_add(1, std::memory_order_relaxed)] = ve.second;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>>().swap(chunk_entries[c]);
+    });
+
+    // Sort every row, drop duplicates, and compact the rows into the final CSR arrays.
+    std::vector<std::size_t> unique_count(N, 0);
+    parallel_chunks(N, num_threads, [&](std::size_t v_begin, std::size_t v_end) {
+        for (std::size_t v = v_begin; v < v_end; ++v) {
+            auto row = raw_hyperedges.begin() + raw_offsets[v];
+            auto row_end = raw_hyperedges.begin() + raw_offsets[v + 1];
+            std::sort(row, row_end);
+            unique_count[v] = static_cast<std::size_t>(std::unique(row, row_end) - row);
+        }
+    });
+    H.vertex_offsets.assign(N + 1, 0);
+    for (std::size_t v = 0; v < N; ++v) H.vertex_offsets[v + 1] = H.vertex_offsets[v] + unique_count[v];
+    H.vertex_hyperedges.resize(H.vertex_offsets[N]);
+    parallel_chunks(N, num_threads, [&](std::size_t v_begin, std::size_t v_end) {
+        for (std::size_t v = v_begin; v < v_end; ++v)
+            std::copy(raw_hyperedges.begin() + raw_offsets[v], raw_hyperedges.begin() + raw_offsets[v] + unique_count[v],
+                      H.vertex_hyperedges.begin() + H.vertex_offsets[v]);
+    });
+    std::vector<std::uint32_t>().swap(raw_hyperedges);
+
+    transpose_incidence_index(H.vertex_offsets, H.vertex_hyperedges, E, num_threads, H.hyperedge_offsets, H.hyperedge_vertices);
+    unlabeled(H);
+    return H;
+}
+
+void read_seed_labels(const std::string& path, std::vector<std::uint32_t>& labels) {
+    MappedFile file(path);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* end = p + file.size();
+
+    std::size_t count = 0;
+    while (true) {
+        while (p < end && (is_blank(*p) || *p == '\n')) ++p;
+        if (p == end) break;
+        bool negative = *p == '-';
+        if (negative || *p == '+') ++p;
+        std::uint64_t value = 0;
+        const char* digits = p;
+        while (p < end && *p >= '0' && *p <= '9') value = value * 10 + static_cast<std::uint64_t>(*p++ - '0');
+        if (p == digits) throw std::runtime_error(path + ": expected an integer label");
+        if (count == labels.size()) throw std::runtime_error(path + ": more labels than vertices");
+        labels[count++] = negative || value >= std::numeric_limits<std::uint32_t>::max()
+                              ? std::numeric_limits<std::uint32_t>::max()
+                              : static_cast<std::uint32_t>(value);
+    }
+    if (count != labels.size())
+        throw std::runtime_error(path + ": " + std::to_string(count) + " labels for " + std::to_string(labels.size()) + " vertices");
+}
@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "headers/partitioned.h"
+#include "headers/label_counting.h"
+
+namespace {
+
+constexpr uint32_t UNASSIGNED = std::numeric_limits<uint32_t>::max();
+
+inline size_t round_up(size_t n) {
+    return (n + WorkGroupSize - 1) / WorkGroupSize * WorkGroupSize;
+}
+
+// One work-item per row, as the engine's WorkItem mapping. Raises *changed_flag when a label changes.
+template <bool Sparse>
+sycl::event submit_rows(sycl::queue& q, size_t rows, const size_t* offsets, const uint32_t* indices,
+                        const uint32_t* in_labels, uint32_t* out_labels, int* changed_flag, uint32_t* scratch) {
+    return q.submit([&](sycl::handler& h) {
+        sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, Sparse ? 1 : MaxLabels}, h);
+        h.parallel_for(sycl::nd_range<1>(round_up(rows), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+            size_t r = idx.get_global_id(0);
+            if (r >= rows) return;
+
+            uint32_t best_label;
+            if constexpr (Sparse) {
+                best_label = most_frequent_label_sorted(scratch, in_labels, indices, offsets[r], offsets[r + 1]);
+            } else {
+                best_label = most_frequent_label(label_counts_acc[idx.get_local_id(0)], in_labels, indices, offsets[r], offsets[r + 1]);
+            }
+
+            if (best_label != INVALID_LABEL && out_labels[r] != best_label) {
+                out_labels[r] = best_label;
+                if (changed_flag != nullptr) {
+                    sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                     sycl::memory_scope::device,
+                                     sycl::access::address_space::global_space>
+                        af(*changed_flag);
+                    af.store(1);
+                }
+            }
+        });
+    });
+}
+
+sycl::event submit_rows(sycl::queue& q, bool sparse, size_t rows, const size_t* offsets, const uint32_t* indices,
+                        const uint32_t* in_labels, uint32_t* out_labels, int* changed_flag, uint32_t* scratch) {
+    if (sparse) return submit_rows<true>(q, rows, offsets, indices, in_labels, out_labels, changed_flag, scratch);
+    return submit_rows<false>(q, rows, offsets, indices, in_labels, out_labels, changed_flag, scratch);
+}
+
+double event_ms(const sycl::event& e) {
+    auto start = e.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = e.get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) / 1e6;
+}
+
+} // namespace
+
+HypergraphPartition partition_hypergraph(const HypergraphSparse& H, size_t num_parts) {
+    const size_t N = H.num_vertices;
+    const size_t E = H.num_hyperedges;
+
+    HypergraphPartition partition;
+    partition.num_parts = std::max<size_t>(num_parts, 1);
+    const size_t P = partition.num_parts;
+
+    // Every vertex weighs its degree plus one, so isolated vertices are spread as well.
+    const size_t total_weight = H.num_incidences() + N;
+    partition.vertex_part.resize(N);
+    size_t part = 0;
+    for (size_t v = 0; v < N; ++v) {
+        while (part + 1 < P && (H.vertex_offsets[v] + v) * P >= (part + 1) * total_weight) ++part;
+        partition.vertex_part[v] = static_cast<uint32_t>(part);
+    }
+
+    partition.hyperedge_part.resize(E);
+    std::vector<size_t> counts(P);
+    for (size_t e = 0; e < E; ++e) {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t k = H.hyperedge_offsets[e]; k < H.hyperedge_offsets[e + 1]; ++k) {
+            counts[partition.vertex_part[H.hyperedge_vertices[k]]]++;
+        }
+        size_t best = e * P / E;
+        if (H.hyperedge_offsets[e + 1] > H.hyperedge_offsets[e]) {
+            best = std::max_element(counts.begin(), counts.end()) - counts.begin();
+        }
+        partition.hyperedge_part[e] = static_cast<uint32_t>(best);
+    }
+
+    return partition;
+}
+
+std::vector<sycl::queue> partition_queues(size_t max_queues) {
+    std::vector<sycl::device> devices = sycl::device::get_devices(sycl::info::device_type::gpu);
+
+    if (devices.size() < 2) {
+        devices.clear();
+        try {
+            sycl::device cpu(sycl::cpu_selector_v);
+            if (cpu.get_info<sycl::info::device::partition_max_sub_devices>() > 1) {
+                devices = cpu.create_sub_devices<sycl::info::partition_property::partition_by_affinity_domain>(
+                    sycl::info::partition_affinity_domain::numa);
+            }
+        } catch (const sycl::exception&) {
+            devices.clear();   // no CPU device, or it cannot be split by NUMA node
+        }
+    }
+
+    if (devices.size() < 2) {
+        devices.assign(1, sycl::device(sycl::default_selector_v));
+    }
+    if (max_queues != 0 && devices.size() > max_queues) {
+        devices.resize(max_queues);
+    }
+
+    std::vector<sycl::queue> queues;
+    for (const sycl::device& d : devices) {
+        queues.emplace_back(d, sycl::property_list{sycl::property::queue::in_order(), sycl::property::queue::enable_profiling()});
+    }
+    return queues;
+}
+
+// Exchanges rely on in-order execution, as in the engine; profiling is kept when the queue had it.
+PartitionedLabelPropagation::Partition::Partition(const sycl::queue& queue) : q(queue) {
+    if (q.is_in_order()) return;
+    if (queue.has_property<sycl::property::queue::enable_profiling>()) {
+        q = sycl::queue(queue.get_context(), queue.get_device(),
+                        sycl::property_list{sycl::property::queue::in_order(), sycl::property::queue::enable_profiling()});
+    } else {
+        q = sycl::queue(queue.get_context(), queue.get_device(), sycl::property::queue::in_order());
+    }
+}
+
+PartitionedLabelPropagation::PartitionedLabelPropagation(const HypergraphSparse& H, std::vector<sycl::queue> queues)
+    : PartitionedLabelPropagation(H, queues, partition_hypergraph(H, queues.size())) {}
+
+PartitionedLabelPropagation::PartitionedLabelPropagation(const HypergraphSparse& H, std::vector<sycl::queue> queues,
+                                                         const HypergraphPartition& partition)
+    : N(H.num_vertices), E(H.num_hyperedges) {
+    assert(!queues.empty() && "at least one queue is required");
+    build(H, queues, partition);
+}
+
+PartitionedLabelPropagation::~PartitionedLabelPropagation() {
+    for (Partition& part : parts) {
+        for (Side* side : {&part.vertices, &part.hyperedges}) {
+            sycl::free(side->offsets_dev, part.q);
+            sycl::free(side->indices_dev, part.q);
+            sycl::free(side->labels_dev, part.q);
+            sycl::free(side->export_ids_dev, part.q);
+            sycl::free(side->export_labels_dev, part.q);
+        }
+        sycl::free(part.changed_dev, part.q);
+        if (part.scratch_dev != nullptr) sycl::free(part.scratch_dev, part.q);
+    }
+}
+
+// Partition p runs on queues[p % queues.size()].
+void PartitionedLabelPropagation::build(const HypergraphSparse& H, std::vector<sycl::queue>& queues, const HypergraphPartition& partition) {
+    const size_t P = partition.num_parts;
+    parts.reserve(P);
+    for (size_t p = 0; p < P; ++p) parts.emplace_back(queues[p % queues.size()]);
+
+    // Global -> local id of the partition being built; reset after each partition.
+    std::vector<uint32_t> local_vertex(N, UNASSIGNED);
+    std::vector<uint32_t> local_hyperedge(E, UNASSIGNED);
+
+    // Local rows of one side: the owned entries of `rows`, reading entries of `cols` through `local_cols`.
+    // Remote entries are appended to cols as halo; their global ids are parked in cols.import_slots.
+    auto local_rows = [](const Side& rows, Side& cols, std::vector<uint32_t>& local_cols,
+                         const std::vector<size_t>& offsets, const std::vector<uint32_t>& indices,
+                         std::vector<size_t>& local_offsets, std::vector<uint32_t>& local_indices) {
+        local_offsets.assign(1, 0);
+        local_indices.clear();
+        for (uint32_t r : rows.global_ids) {
+            for (size_t k = offsets[r]; k < offsets[r + 1]; ++k) {
+                uint32_t c = indices[k];
+                if (local_cols[c] == UNASSIGNED) {
+                    local_cols[c] = static_cast<uint32_t>(cols.owned + cols.import_slots.size());
+                    cols.import_slots.push_back(c);
+                }
+                local_indices.push_back(local_cols[c]);
+            }
+            local_offsets.push_back(local_indices.size());
+        }
+    };
+
+    std::vector<size_t> he_offsets, v_offsets;
+    std::vector<uint32_t> he_vertices, v_hyperedges;
+
+    for (size_t p = 0; p < P; ++p) {
+        Partition& part = parts[p];
+        for (size_t v = 0; v < N; ++v) {
+            if (partition.vertex_part[v] != p) continue;
+            local_vertex[v] = static_cast<uint32_t>(part.vertices.global_ids.size());
+            part.vertices.global_ids.push_back(static_cast<uint32_t>(v));
+        }
+        for (size_t e = 0; e < E; ++e) {
+            if (partition.hyperedge_part[e] != p) continue;
+            local_hyperedge[e] = static_cast<uint32_t>(part.hyperedges.global_ids.size());
+            part.hyperedges.global_ids.push_back(static_cast<uint32_t>(e));
+        }
+        part.vertices.owned = part.vertices.global_ids.size();
+        part.hyperedges.owned = part.hyperedges.global_ids.size();
+
+        local_rows(part.hyperedges, part.vertices, local_vertex, H.hyperedge_offsets, H.hyperedge_vertices, he_offsets, he_vertices);
+        local_rows(part.vertices, part.hyperedges, local_hyperedge, H.vertex_offsets, H.vertex_hyperedges, v_offsets, v_hyperedges);
+        part.vertices.halo = part.vertices.import_slots.size();
+        part.hyperedges.halo = part.hyperedges.import_slots.size();
+        part.nnz = he_vertices.size() + v_hyperedges.size();
+
+        sycl::queue& q = part.q;
+        for (auto [side, offsets, indices] : {std::make_tuple(&part.hyperedges, &he_offsets, &he_vertices),
+                                              std::make_tuple(&part.vertices, &v_offsets, &v_hyperedges)}) {
+            side->offsets_dev = sycl::malloc_device<size_t>(offsets->size(), q);
+            side->indices_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(indices->size(), 1), q);
+            side->labels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(side->owned + side->halo, 1), q);
+            q.memcpy(side->offsets_dev, offsets->data(), offsets->size() * sizeof(size_t));
+            q.memcpy(side->indices_dev, indices->data(), indices->size() * sizeof(uint32_t));
+            q.wait();
+        }
+        part.changed_dev = sycl::malloc_device<int>(1, q);
+
+        for (uint32_t v : part.vertices.global_ids) local_vertex[v] = UNASSIGNED;
+        for (uint32_t v : part.vertices.import_slots) local_vertex[v] = UNASSIGNED;
+        for (uint32_t e : part.hyperedges.global_ids) local_hyperedge[e] = UNASSIGNED;
+        for (uint32_t e : part.hyperedges.import_slots) local_hyperedge[e] = UNASSIGNED;
+    }
+
+    // Boundary slots: owned entries read by another partition, grouped by owner so each partition
+    // exports one contiguous range. The halo global ids parked in import_slots become slots.
+    auto assign_boundary = [this](Side Partition::*member, size_t count, std::vector<uint32_t>& boundary) {
+        std::vector<uint32_t> slot(count, UNASSIGNED);
+        for (Partition& part : parts) {
+            for (uint32_t g : (part.*member).import_slots) slot[g] = 0;
+        }
+
+        size_t slots = 0;
+        for (Partition& part : parts) {
+            Side& side = part.*member;
+            std::vector<uint32_t> export_ids;
+            side.export_base = slots;
+            for (size_t i = 0; i < side.owned; ++i) {
+                uint32_t g = side.global_ids[i];
+                if (slot[g] == UNASSIGNED) continue;
+                slot[g] = static_cast<uint32_t>(slots++);
+                export_ids.push_back(static_cast<uint32_t>(i));
+            }
+            side.export_count = export_ids.size();
+
+            side.export_ids_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(side.export_count, 1), part.q);
+            side.export_labels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(side.export_count, 1), part.q);
+            part.q.memcpy(side.export_ids_dev, export_ids.data(), side.export_count * sizeof(uint32_t)).wait();
+        }
+
+        for (Partition& part : parts) {
+            Side& side = part.*member;
+            for (uint32_t& s : side.import_slots) s = slot[s];
+            side.import_staging.resize(side.halo);
+        }
+        boundary.resize(slots);
+    };
+
+    assign_boundary(&Partition::vertices, N, vertex_boundary);
+    assign_boundary(&Partition::hyperedges, E, hyperedge_boundary);
+}
+
+// Packs every partition's exported labels of one side into the boundary array, then refreshes all
+// halos of that side from it. The halo copies are left queued; later kernels on the same in-order
+// queue see them.
+void PartitionedLabelPropagation::exchange(Side Partition::*member, std::vector<uint32_t>& boundary) {
+    for (Partition& part : parts) {
+        Side& side = part.*member;
+        if (side.export_count == 0) continue;
+
+        const uint32_t* labels = side.labels_dev;
+        const uint32_t* export_ids = side.export_ids_dev;
+        uint32_t* export_labels = side.export_labels_dev;
+        part.q.parallel_for(sycl::range<1>(side.export_count), [=](sycl::id<1> i) {
+            export_labels[i] = labels[export_ids[i]];
+        });
+        part.q.memcpy(boundary.data() + side.export_base, export_labels, side.export_count * sizeof(uint32_t));
+    }
+    for (Partition& part : parts) part.q.wait();
+
+    for (Partition& part : parts) {
+        Side& side = part.*member;
+        if (side.halo == 0) continue;
+
+        for (size_t j = 0; j < side.halo; ++j) side.import_staging[j] = boundary[side.import_slots[j]];
+        part.q.memcpy(side.labels_dev + side.owned, side.import_staging.data(), side.halo * sizeof(uint32_t));
+    }
+}
+
+PartitionedResult PartitionedLabelPropagation::run(const std::vector<uint32_t>& seed_labels, const LabelPropagationOptions& options) {
+    assert(seed_labels.size() == N && "seed_labels size mismatch");
+
+    PartitionedResult result;
+    result.label_counting = resolve_label_counting(options.label_counting, seed_labels);
+    const bool sparse = result.label_counting == LabelCounting::Sparse;
+
+    std::vector<uint32_t> owned_labels;
+    for (Partition& part : parts) {
+        if (sparse && part.scratch_dev == nullptr) {
+            part.scratch_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(part.nnz, 1), part.q);
+        }
+        part.kernels.clear();
+
+        owned_labels.resize(part.vertices.owned);
+        for (size_t i = 0; i < part.vertices.owned; ++i) owned_labels[i] = seed_labels[part.vertices.global_ids[i]];
+        part.q.memcpy(part.vertices.labels_dev, owned_labels.data(), part.vertices.owned * sizeof(uint32_t));
+        part.q.fill(part.hyperedges.labels_dev, INVALID_LABEL, part.hyperedges.owned + part.hyperedges.halo);
+        part.q.wait();
+    }
+    exchange(&Partition::vertices, vertex_boundary);
+
+    std::vector<int> changed_host(parts.size());
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    while (result.iterations < options.max_iterations && !result.converged) {
+        for (Partition& part : parts) {
+            if (part.hyperedges.owned == 0) continue;
+            part.kernels.push_back(submit_rows(part.q, sparse, part.hyperedges.owned, part.hyperedges.offsets_dev,
+                                               part.hyperedges.indices_dev, part.vertices.labels_dev,
+                                               part.hyperedges.labels_dev, nullptr, part.scratch_dev));
+        }
+        for (Partition& part : parts) part.q.wait();
+        auto exchange_start = std::chrono::high_resolution_clock::now();
+        exchange(&Partition::hyperedges, hyperedge_boundary);
+        result.exchange_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - exchange_start).count();
+
+        for (size_t p = 0; p < parts.size(); ++p) {
+            Partition& part = parts[p];
+            part.q.memset(part.changed_dev, 0, sizeof(int));
+            if (part.vertices.owned != 0) {
+                part.kernels.push_back(submit_rows(part.q, sparse, part.vertices.owned, part.vertices.offsets_dev,
+                                                   part.vertices.indices_dev, part.hyperedges.labels_dev,
+                                                   part.vertices.labels_dev, part.changed_dev, part.scratch_dev));
+            }
+            part.q.memcpy(&changed_host[p], part.changed_dev, sizeof(int));
+        }
+        for (Partition& part : parts) part.q.wait();
+        exchange_start = std::chrono::high_resolution_clock::now();
+        exchange(&Partition::vertices, vertex_boundary);
+        result.exchange_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - exchange_start).count();
+
+        ++result.iterations;
+        result.converged = std::all_of(changed_host.begin(), changed_host.end(), [](int c) { return c == 0; });
+    }
+    for (Partition& part : parts) part.q.wait();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+    result.vertex_labels.resize(N);
+    result.hyperedge_labels.resize(E);
+    for (Partition& part : parts) {
+        for (auto [side, labels] : {std::make_pair(&part.vertices, &result.vertex_labels),
+                                    std::make_pair(&part.hyperedges, &result.hyperedge_labels)}) {
+            owned_labels.resize(side->owned);
+            part.q.memcpy(owned_labels.data(), side->labels_dev, side->owned * sizeof(uint32_t)).wait();
+            for (size_t i = 0; i < side->owned; ++i) (*labels)[side->global_ids[i]] = owned_labels[i];
+        }
+
+        PartitionStats stats;
+        stats.num_vertices = part.vertices.owned;
+        stats.num_hyperedges = part.hyperedges.owned;
+        stats.halo_vertices = part.vertices.halo;
+        stats.halo_hyperedges = part.hyperedges.halo;
+        stats.num_incidences = part.nnz;
+        if (part.q.has_property<sycl::property::queue::enable_profiling>()) {
+            for (const sycl::event& e : part.kernels) stats.compute_ms += event_ms(e);
+        }
+        result.partitions.push_back(stats);
+    }
+
+    return result;
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <sycl/sycl.hpp>
+#include "headers/streamed.h"
+#include "headers/label_counting.h"
+
+namespace {
+
+inline size_t round_up(size_t n) {
+    return (n + WorkGroupSize - 1) / WorkGroupSize * WorkGroupSize;
+}
+
+// One work-item per row of a tile. offsets holds the tile's rows + 1 global offsets, so base
+// (the first of them) turns them into positions in the tile's indices.
+template <bool Sparse>
+sycl::event submit_tile(sycl::queue& q, const sycl::event& uploaded, size_t rows, size_t first_row,
+                        const size_t* offsets, const uint32_t* indices, const uint32_t* in_labels,
+                        uint32_t* out_labels, int* changed_flag, uint32_t* scratch) {
+    return q.submit([&](sycl::handler& h) {
+        h.depends_on(uploaded);
+        sycl::local_accessor<uint32_t, 2> label_counts_acc({WorkGroupSize, Sparse ? 1 : MaxLabels}, h);
+        h.parallel_for(sycl::nd_range<1>(round_up(rows), WorkGroupSize), [=](sycl::nd_item<1> idx) {
+            size_t r = idx.get_global_id(0);
+            if (r >= rows) return;
+            const size_t base = offsets[0];
+            const size_t begin = offsets[r] - base;
+            const size_t end = offsets[r + 1] - base;
+
+            uint32_t best_label;
+            if constexpr (Sparse) {
+                best_label = most_frequent_label_sorted(scratch, in_labels, indices, begin, end);
+            } else {
+                best_label = most_frequent_label(label_counts_acc[idx.get_local_id(0)], in_labels, indices, begin, end);
+            }
+
+            uint32_t& out = out_labels[first_row + r];
+            if (best_label != INVALID_LABEL && out != best_label) {
+                out = best_label;
+                if (changed_flag != nullptr) {
+                    sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                                     sycl::memory_scope::device,
+                                     sycl::access::address_space::global_space>
+                        af(*changed_flag);
+                    af.store(1);
+                }
+            }
+        });
+    });
+}
+
+} // namespace
+
+IncidenceSource incidence_source(const HypergraphSparse& H) {
+    IncidenceSource source;
+    source.num_vertices = H.num_vertices;
+    source.num_hyperedges = H.num_hyperedges;
+    source.num_incidences = H.num_incidences();
+    source.vertex_offsets = H.vertex_offsets.data();
+    source.vertex_hyperedges = H.vertex_hyperedges.data();
+    source.hyperedge_offsets = H.hyperedge_offsets.data();
+    source.hyperedge_vertices = H.hyperedge_vertices.data();
+    return source;
+}
+
+IncidenceSource incidence_source(const MappedHypergraph& M) {
+    if (M.layout() != HypergraphLayout::CSR) {
+        throw std::runtime_error("streamed execution needs a hypergraph file with the CSR layout");
+    }
+    static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "offsets are stored as uint64_t");
+
+    IncidenceSource source;
+    source.num_vertices = M.header().num_vertices;
+    source.num_hyperedges = M.header().num_hyperedges;
+    source.num_incidences = M.header().num_incidences;
+    source.vertex_offsets = reinterpret_cast<const size_t*>(M.vertex_offsets());
+    source.vertex_hyperedges = M.vertex_hyperedges();
+    source.hyperedge_offsets = reinterpret_cast<const size_t*>(M.hyperedge_offsets());
+    source.hyperedge_vertices = M.hyperedge_vertices();
+    return source;
+}
+
+StreamedLabelPropagation::StreamedLabelPropagation(const IncidenceSource& source, size_t tile_incidences)
+    : StreamedLabelPropagation(source, sycl::queue(preferred_device(), sycl::property::queue::in_order()), tile_incidences) {}
+
+StreamedLabelPropagation::StreamedLabelPropagation(const IncidenceSource& source, const sycl::queue& queue, size_t tile_incidences)
+    : src(source),
+      q(queue.is_in_order() ? queue : sycl::queue(queue.get_context(), queue.get_device(), sycl::property::queue::in_order())),
+      copy_q(q.get_context(), q.get_device(), sycl::property::queue::in_order()) {
+    if (tile_incidences == 0) {
+        // Per incidence: indices in both buffers, their row offsets in the worst case, and the sort scratch.
+        const size_t bytes_per_incidence = 2 * (sizeof(uint32_t) + sizeof(size_t)) + sizeof(uint32_t);
+        const size_t global_mem = q.get_device().get_info<sycl::info::device::global_mem_size>();
+        const size_t max_alloc = q.get_device().get_info<sycl::info::device::max_mem_alloc_size>();
+        tile_incidences = std::min(global_mem / 4 / bytes_per_incidence, max_alloc / sizeof(size_t));
+    }
+    tile_incidences = std::max<size_t>(tile_incidences, 1);
+
+    hyperedge_tiles = make_tiles(src.hyperedge_offsets, src.num_hyperedges, tile_incidences);
+    vertex_tiles = make_tiles(src.vertex_offsets, src.num_vertices, tile_incidences);
+    auto track_sizes = [this](const std::vector<Tile>& tiles, const size_t* offsets) {
+        for (const Tile& t : tiles) {
+            max_tile_rows = std::max(max_tile_rows, t.last_row - t.first_row);
+            max_tile_incidences = std::max(max_tile_incidences, offsets[t.last_row] - offsets[t.first_row]);
+        }
+    };
+    track_sizes(hyperedge_tiles, src.hyperedge_offsets);
+    track_sizes(vertex_tiles, src.vertex_offsets);
+
+    for (TileBuffer& b : buffers) {
+        b.offsets_host = sycl::malloc_host<size_t>(max_tile_rows + 1, q);
+        b.indices_host = sycl::malloc_host<uint32_t>(std::max<size_t>(max_tile_incidences, 1), q);
+        b.offsets_dev = sycl::malloc_device<size_t>(max_tile_rows + 1, q);
+        b.indices_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(max_tile_incidences, 1), q);
+    }
+    vlabels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(src.num_vertices, 1), q);
+    helabels_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(src.num_hyperedges, 1), q);
+}
+
+StreamedLabelPropagation::~StreamedLabelPropagation() {
+    q.wait();
+    copy_q.wait();
+    for (TileBuffer& b : buffers) {
+        sycl::free(b.offsets_host, q);
+        sycl::free(b.indices_host, q);
+        sycl::free(b.offsets_dev, q);
+        sycl::free(b.indices_dev, q);
+    }
+    sycl::free(vlabels_dev, q);
+    sycl::free(helabels_dev, q);
+    if (scratch_dev != nullptr) sycl::free(scratch_dev, q);
+    if (changed_dev != nullptr) sycl::free(changed_dev, q);
+}
+
+// Consecutive rows until the tile would exceed budget rows or budget incidences; a longer row gets a tile of its own.
+std::vector<StreamedLabelPropagation::Tile> StreamedLabelPropagation::make_tiles(const size_t* offsets, size_t rows, size_t budget) const {
+    std::vector<Tile> tiles;
+    for (size_t r = 0; r < rows;) {
+        const size_t first = r++;
+        while (r < rows && r - first < budget && offsets[r + 1] - offsets[first] <= budget) ++r;
+        tiles.push_back({first, r});
+    }
+    return tiles;
+}
+
+// Tile t waits on the host until the upload of tile t - 2 has left the staging buffer, its upload waits
+// on the device for the kernel of tile t - 2, and its kernel waits for its upload. The kernels stay
+// ordered by the in-order compute queue, so the hyperedge phase still finishes before the vertex phase.
+void StreamedLabelPropagation::stream_side(const std::vector<Tile>& tiles, const size_t* offsets, const uint32_t* indices,
+                                           const uint32_t* in_labels, uint32_t* out_labels, int* changed_flag, bool sparse,
+                                           StreamedResult& result) {
+    for (const Tile& t : tiles) {
+        TileBuffer& b = buffers[next_buffer];
+        next_buffer ^= 1;
+
+        const size_t rows = t.last_row - t.first_row;
+        const size_t base = offsets[t.first_row];
+        const size_t nnz = offsets[t.last_row] - base;
+
+        b.uploaded.wait();
+        std::memcpy(b.offsets_host, offsets + t.first_row, (rows + 1) * sizeof(size_t));
+        std::memcpy(b.indices_host, indices + base, nnz * sizeof(uint32_t));
+        copy_q.memcpy(b.offsets_dev, b.offsets_host, (rows + 1) * sizeof(size_t), b.consumed);
+        b.uploaded = copy_q.memcpy(b.indices_dev, b.indices_host, nnz * sizeof(uint32_t));
+        result.bytes_streamed += (rows + 1) * sizeof(size_t) + nnz * sizeof(uint32_t);
+
+        if (sparse) {
+            b.consumed = submit_tile<true>(q, b.uploaded, rows, t.first_row, b.offsets_dev, b.indices_dev,
+                                           in_labels, out_labels, changed_flag, scratch_dev);
+        } else {
+            b.consumed = submit_tile<false>(q, b.uploaded, rows, t.first_row, b.offsets_dev, b.indices_dev,
+                                            in_labels, out_labels, changed_flag, scratch_dev);
+        }
+    }
+}
+
+StreamedResult StreamedLabelPropagation::run(const std::vector<uint32_t>& seed_labels, const LabelPropagationOptions& options) {
+    assert(seed_labels.size() == src.num_vertices && "seed_labels size mismatch");
+    const size_t N = src.num_vertices;
+    const size_t E = src.num_hyperedges;
+
+    q.memcpy(vlabels_dev, seed_labels.data(), N * sizeof(uint32_t)).wait();
+    q.fill(helabels_dev, INVALID_LABEL, E).wait();
+
+    StreamedResult result;
+    result.label_counting = resolve_label_counting(options.label_counting, seed_labels);
+    result.tiles_per_iteration = hyperedge_tiles.size() + vertex_tiles.size();
+    const bool sparse = result.label_counting == LabelCounting::Sparse;
+    if (sparse && scratch_dev == nullptr) {
+        scratch_dev = sycl::malloc_device<uint32_t>(std::max<size_t>(max_tile_incidences, 1), q);
+    }
+    if (changed_capacity < options.max_iterations) {
+        if (changed_dev != nullptr) sycl::free(changed_dev, q);
+        changed_dev = sycl::malloc_device<int>(options.max_iterations, q);
+        changed_capacity = options.max_iterations;
+    }
+    q.memset(changed_dev, 0, options.max_iterations * sizeof(int)).wait();
+
+    const size_t check_interval = std::max<size_t>(1, options.convergence_check_interval);
+    std::vector<int> changed_host(options.max_iterations);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    while (result.iterations < options.max_iterations && !result.converged) {
+        size_t batch_end = std::min(result.iterations + check_interval, options.max_iterations);
+        for (size_t it = result.iterations; it < batch_end; ++it) {
+            stream_side(hyperedge_tiles, src.hyperedge_offsets, src.hyperedge_vertices, vlabels_dev, helabels_dev, nullptr, sparse, result);
+            stream_side(vertex_tiles, src.vertex_offsets, src.vertex_hyperedges, helabels_dev, vlabels_dev, changed_dev + it, sparse, result);
+        }
+
+        q.memcpy(changed_host.data() + result.iterations, changed_dev + result.iterations,
+                 (batch_end - result.iterations) * sizeof(int)).wait();
+        while (result.iterations < batch_end && !result.converged) {
+            result.converged = changed_host[result.iterations++] == 0;
+        }
+    }
+    copy_q.wait();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+    result.vertex_labels.resize(N);
+    result.hyperedge_labels.resize(E);
+    q.memcpy(result.vertex_labels.data(), vlabels_dev, N * sizeof(uint32_t));
+    q.memcpy(result.hyperedge_labels.data(), helabels_dev, E * sizeof(uint32_t));
+    q.wait();
+
+    return result;
+}
@@ -0,0 +1,48 @@
+#include <fstream>
+#include <stdexcept>
+#include "headers/trace.h"
+
+static std::ofstream open_trace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("cannot write " + path);
+    return out;
+}
+
+// Changed count reported for the event, or -1 for commands outside the two phases.
+static long long changed_count(const PropagationTrace& trace, const TraceEvent& e) {
+    if (e.iteration >= trace.iterations.size()) return -1;
+    if (e.name == "hyperedge_phase") return trace.iterations[e.iteration].hyperedges;
+    if (e.name == "vertex_phase") return trace.iterations[e.iteration].vertices;
+    return -1;
+}
+
+void PropagationTrace::write_chrome_trace(const std::string& path) const {
+    std::ofstream out = open_trace(path);
+    out << "{\"traceEvents\": [\n";
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& e = events[i];
+        // Chrome traces count in microseconds.
+        out << "  {\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0"
+            << ", \"ts\": " << e.start_ns / 1e3 << ", \"dur\": " << (e.end_ns - e.start_ns) / 1e3
+            << ", \"args\": {\"iteration\": " << e.iteration << "}}";
+
+        long long changed = changed_count(*this, e);
+        if (changed >= 0) {
+            out << ",\n  {\"name\": \"changed " << (e.name == "vertex_phase" ? "vertices" : "hyperedges")
+                << "\", \"ph\": \"C\", \"pid\": 0, \"ts\": " << e.end_ns / 1e3 << ", \"args\": {\"count\": " << changed << "}}";
+        }
+        out << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+}
+
+void PropagationTrace::write_csv(const std::string& path) const {
+    std::ofstream out = open_trace(path);
+    out << "name,iteration,start_ns,duration_ns,changed\n";
+    for (const TraceEvent& e : events) {
+        out << e.name << "," << e.iteration << "," << e.start_ns << "," << e.end_ns - e.start_ns << ",";
+        long long changed = changed_count(*this, e);
+        if (changed >= 0) out << changed;
+        out << "\n";
+    }
+}
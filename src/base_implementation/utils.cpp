@@ -6,16 +6,41 @@
 #include<string>
 #include<iostream>
 #include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "../base_implementation/headers/philox.h"
+#include "../base_implementation/headers/parallel.h"
 
-HypergraphNotSparse generate_hypergraph(std::size_t N, std::size_t E, double p) {
-    HypergraphNotSparse H;
+// 40% of the vertices get a seed label in 0..5, every hyperedge starts unlabeled.
+template <typename Label>
+static void seed_labels(std::mt19937& gen, std::size_t N, std::size_t E,
+                        std::vector<Label>& vertex_labels, std::vector<Label>& hyperedge_labels) {
+    vertex_labels.resize(N);
+    std::uniform_int_distribution<int> label_dist(0, 5);
+    std::bernoulli_distribution labeled(0.4);
+    for (size_t i = 0; i < N; ++i) {
+        if (labeled(gen)) {
+            vertex_labels[i] = label_dist(gen);
+        } else {
+            vertex_labels[i] = std::numeric_limits<Label>::max();
+        }
+    }
+
+    hyperedge_labels.resize(E);
+    std::fill(hyperedge_labels.begin(), hyperedge_labels.end(), std::numeric_limits<Label>::max());
+}
+
+template <typename Label, typename Incidence>
+BasicHypergraphNotSparse<Label, Incidence> generate_hypergraph(std::size_t N, std::size_t E, double p, const IncidenceAllocation& allocation) {
+    BasicHypergraphNotSparse<Label, Incidence> H;
     H.num_vertices = N;
     H.num_hyperedges = E;
 
     std::mt19937 gen(42);
     std::bernoulli_distribution dist(p);
 
-    H.incidence_matrix.resize(N, std::vector<uint32_t>(E, 0));
+    H.incidence_matrix.resize(N, E, allocation);
 
     for (std::size_t e = 0; e < E; ++e) {
         std::unordered_set<std::size_t> nodes;
@@ -53,19 +78,292 @@ HypergraphNotSparse generate_hypergraph(std::size_t N, std::size_t E, double p)
         }
     }
 
-    H.vertex_labels.resize(N);
-    std::uniform_int_distribution<int> label_dist(0, 5);
-    std::bernoulli_distribution labeled(0.4);
-    for (size_t i = 0; i < N; ++i) {
-        if (labeled(gen)) {
-            H.vertex_labels[i] = label_dist(gen);
-        } else {
-            H.vertex_labels[i] = std::numeric_limits<std::uint32_t>::max();
+    seed_labels(gen, N, E, H.vertex_labels, H.hyperedge_labels);
+
+    return H;
+}
+
+#define INSTANTIATE_GENERATE_HYPERGRAPH(Label) \
+    template BasicHypergraphNotSparse<Label, std::uint8_t> generate_hypergraph<Label, std::uint8_t>(std::size_t, std::size_t, double, const IncidenceAllocation&); \
+    template BasicHypergraphNotSparse<Label, std::uint16_t> generate_hypergraph<Label, std::uint16_t>(std::size_t, std::size_t, double, const IncidenceAllocation&); \
+    template BasicHypergraphNotSparse<Label, std::uint32_t> generate_hypergraph<Label, std::uint32_t>(std::size_t, std::size_t, double, const IncidenceAllocation&);
+
+INSTANTIATE_GENERATE_HYPERGRAPH(std::uint8_t)
+INSTANTIATE_GENERATE_HYPERGRAPH(std::uint16_t)
+INSTANTIATE_GENERATE_HYPERGRAPH(std::uint32_t)
+
+void build_hyperedge_index(HypergraphSparse& H) {
+    const std::size_t N = H.num_vertices;
+    const std::size_t E = H.num_hyperedges;
+
+    H.hyperedge_offsets.assign(E + 1, 0);
+    for (std::uint32_t e : H.vertex_hyperedges) {
+        H.hyperedge_offsets[e + 1]++;
+    }
+    std::partial_sum(H.hyperedge_offsets.begin(), H.hyperedge_offsets.end(), H.hyperedge_offsets.begin());
+
+    H.hyperedge_vertices.resize(H.vertex_hyperedges.size());
+    std::vector<std::size_t> cursor(H.hyperedge_offsets.begin(), H.hyperedge_offsets.end() - 1);
+    for (std::size_t v = 0; v < N; ++v) {
+        for (std::size_t k = H.vertex_offsets[v]; k < H.vertex_offsets[v + 1]; ++k) {
+            H.hyperedge_vertices[cursor[H.vertex_hyperedges[k]]++] = static_cast<std::uint32_t>(v);
+        }
+    }
+}
+
+HypergraphSparse to_sparse(const HypergraphNotSparse& H) {
+    HypergraphSparse S;
+    S.num_vertices = H.num_vertices;
+    S.num_hyperedges = H.num_hyperedges;
+
+    S.vertex_offsets.assign(H.num_vertices + 1, 0);
+    for (std::size_t v = 0; v < H.num_vertices; ++v) {
+        for (std::size_t e = 0; e < H.num_hyperedges; ++e) {
+            if (H.incidence_matrix[v][e] == 1) {
+                S.vertex_hyperedges.push_back(static_cast<std::uint32_t>(e));
+            }
+        }
+        S.vertex_offsets[v + 1] = S.vertex_hyperedges.size();
+    }
+
+    build_hyperedge_index(S);
+
+    S.vertex_labels = H.vertex_labels;
+    S.hyperedge_labels = H.hyperedge_labels;
+
+    return S;
+}
+
+HypergraphBitset to_bitset(const HypergraphNotSparse& H) {
+    HypergraphBitset B;
+    B.num_vertices = H.num_vertices;
+    B.num_hyperedges = H.num_hyperedges;
+    B.words_per_row = bitset_words_per_row(H.num_hyperedges);
+
+    B.incidence_bits.assign(B.num_vertices * B.words_per_row, 0);
+    for (std::size_t v = 0; v < H.num_vertices; ++v) {
+        std::uint64_t* row = B.incidence_bits.data() + v * B.words_per_row;
+        for (std::size_t e = 0; e < H.num_hyperedges; ++e) {
+            if (H.incidence_matrix[v][e] == 1) {
+                row[e / BitsetWordBits] |= std::uint64_t(1) << (e % BitsetWordBits);
+            }
+        }
+    }
+
+    B.vertex_labels = H.vertex_labels;
+    B.hyperedge_labels = H.hyperedge_labels;
+
+    return B;
+}
+
+HypergraphNotSparse to_dense(const HypergraphSparse& S, const IncidenceAllocation& allocation) {
+    HypergraphNotSparse H;
+    H.num_vertices = S.num_vertices;
+    H.num_hyperedges = S.num_hyperedges;
+    H.incidence_matrix.resize(S.num_vertices, S.num_hyperedges, allocation);
+    for (std::size_t v = 0; v < S.num_vertices; ++v)
+        for (std::size_t k = S.vertex_offsets[v]; k < S.vertex_offsets[v + 1]; ++k)
+            H.incidence_matrix[v][S.vertex_hyperedges[k]] = 1;
+
+    H.vertex_labels = S.vertex_labels;
+    H.hyperedge_labels = S.hyperedge_labels;
+    return H;
+}
+
+HypergraphBitset to_bitset(const HypergraphSparse& S) {
+    HypergraphBitset B;
+    B.num_vertices = S.num_vertices;
+    B.num_hyperedges = S.num_hyperedges;
+    B.words_per_row = bitset_words_per_row(S.num_hyperedges);
+
+    B.incidence_bits.assign(B.num_vertices * B.words_per_row, 0);
+    for (std::size_t v = 0; v < S.num_vertices; ++v)
+        for (std::size_t k = S.vertex_offsets[v]; k < S.vertex_offsets[v + 1]; ++k)
+            B.incidence_bits[v * B.words_per_row + S.vertex_hyperedges[k] / BitsetWordBits] |=
+                std::uint64_t(1) << (S.vertex_hyperedges[k] % BitsetWordBits);
+
+    B.vertex_labels = S.vertex_labels;
+    B.hyperedge_labels = S.hyperedge_labels;
+    return B;
+}
+
+void transpose_incidence_index(const std::vector<std::size_t>& row_offsets, const std::vector<std::uint32_t>& row_indices,
+                               std::size_t num_cols, unsigned num_threads,
+                               std::vector<std::size_t>& col_offsets, std::vector<std::uint32_t>& col_indices) {
+    const std::size_t num_rows = row_offsets.size() - 1;
+    const std::size_t nnz = row_indices.size();
+
+    // One column histogram per thread; the thread count is capped so the histograms never outgrow the input.
+    std::size_t max_threads = std::max<std::size_t>(1, nnz / std::max<std::size_t>(num_cols, 1));
+    const unsigned T = static_cast<unsigned>(std::min<std::size_t>(num_threads, max_threads));
+    const std::size_t chunk = chunk_size(num_rows, T);
+    std::vector<std::size_t> position(T * num_cols, 0);
+
+    parallel_chunks(num_rows, T, [&](std::size_t begin, std::size_t end) {
+        if (begin == end) return;
+        std::size_t* counts = position.data() + (begin / chunk) * num_cols;
+        for (std::size_t k = row_offsets[begin]; k < row_offsets[end]; ++k) counts[row_indices[k]]++;
+    });
+
+    // Column c of thread t starts after all of column c from threads < t, so every column comes out sorted.
+    col_offsets.assign(num_cols + 1, 0);
+    for (std::size_t c = 0; c < num_cols; ++c) {
+        std::size_t start = col_offsets[c];
+        for (unsigned t = 0; t < T; ++t) {
+            std::size_t count = position[t * num_cols + c];
+            position[t * num_cols + c] = start;
+            start += count;
         }
+        col_offsets[c + 1] = start;
     }
 
-    H.hyperedge_labels.resize(E);
-    std::fill(H.hyperedge_labels.begin(), H.hyperedge_labels.end(), std::numeric_limits<std::uint32_t>::max());
+    col_indices.resize(nnz);
+    parallel_chunks(num_rows, T, [&](std::size_t begin, std::size_t end) {
+        if (begin == end) return;
+        std::size_t* next = position.data() + (begin / chunk) * num_cols;
+        for (std::size_t r = begin; r < end; ++r)
+            for (std::size_t k = row_offsets[r]; k < row_offsets[r + 1]; ++k)
+                col_indices[next[row_indices[k]]++] = static_cast<std::uint32_t>(r);
+    });
+}
+
+namespace {
+// Philox stream domains, one per independent random decision of the generator.
+enum GeneratorStream : std::uint32_t {
+    HyperedgeStream = 1,
+    VertexDegreeStream = 2,
+    VertexLabelStream = 3,
+};
+}
+
+// Same guarantees as generate_hypergraph, but the Bernoulli(p) fill jumps from one nonzero to the next
+// with geometric gaps, so the cost is O(N + E + nnz) instead of O(N * E). Every hyperedge (and every
+// vertex fix-up and seed label) draws from its own Philox stream keyed on (seed, domain, index), so the
+// output is bit-identical for any num_threads. num_threads = 0 uses all hardware threads.
+HypergraphSparse generate_hypergraph_parallel(std::size_t N, std::size_t E, double p, std::uint64_t seed, unsigned num_threads) {
+    num_threads = resolve_num_threads(num_threads);
+
+    HypergraphSparse H;
+    H.num_vertices = N;
+    H.num_hyperedges = E;
+
+    const double log_q = std::log1p(-std::min(p, 1.0));
+
+    // Hyperedge-major pass: each thread samples a contiguous block of hyperedges into its own buffer.
+    std::vector<std::size_t> he_offsets(E + 1, 0);
+    std::vector<std::vector<std::uint32_t>> block_vertices(num_threads);
+    const std::size_t chunk = chunk_size(E, num_threads);
+
+    parallel_chunks(E, num_threads, [&](std::size_t begin, std::size_t end) {
+        if (begin == end) return;
+        std::vector<std::uint32_t>& out = block_vertices[begin / chunk];
+        for (std::size_t e = begin; e < end; ++e) {
+            PhiloxStream rng(seed, HyperedgeStream, e);
+            std::size_t start = out.size();
+
+            std::size_t a = rng.next_u64() % N;
+            std::size_t b = a;
+            while (b == a) {
+                b = rng.next_u64() % N;
+            }
+            std::size_t forced[2] = {std::min(a, b), std::max(a, b)};
+            std::size_t next_forced = 0;
+
+            auto push = [&](std::size_t v) {
+                while (next_forced < 2 && forced[next_forced] < v) {
+                    out.push_back(static_cast<std::uint32_t>(forced[next_forced++]));
+                }
+                if (next_forced < 2 && forced[next_forced] == v) {
+                    next_forced++;
+                }
+                out.push_back(static_cast<std::uint32_t>(v));
+            };
+
+            if (p >= 1.0) {
+                for (std::size_t v = 0; v < N; ++v) push(v);
+            } else if (p > 0.0) {
+                std::size_t v = 0;
+                while (true) {
+                    double skip = std::floor(std::log(1.0 - rng.next_unit()) / log_q);
+                    if (skip >= static_cast<double>(N - v)) break;
+                    v += static_cast<std::size_t>(skip);
+                    push(v);
+                    v++;
+                }
+            }
+            while (next_forced < 2) {
+                out.push_back(static_cast<std::uint32_t>(forced[next_forced++]));
+            }
+
+            he_offsets[e + 1] = out.size() - start;
+        }
+    });
+
+    for (std::size_t e = 0; e < E; ++e) {
+        he_offsets[e + 1] += he_offsets[e];
+    }
+    std::vector<std::uint32_t> he_vertices(he_offsets[E]);
+    parallel_chunks(E, num_threads, [&](std::size_t begin, std::size_t end) {
+        if (begin == end) return;
+        const std::vector<std::uint32_t>& in = block_vertices[begin / chunk];
+        std::copy(in.begin(), in.end(), he_vertices.begin() + he_offsets[begin]);
+    });
+    std::vector<std::vector<std::uint32_t>>().swap(block_vertices);
+
+    // Vertex-major CSR, then up to two extra hyperedges for every vertex of degree < 2.
+    std::vector<std::size_t> v_offsets;
+    std::vector<std::uint32_t> v_hyperedges;
+    transpose_incidence_index(he_offsets, he_vertices, N, num_threads, v_offsets, v_hyperedges);
+    std::vector<std::size_t>().swap(he_offsets);
+    std::vector<std::uint32_t>().swap(he_vertices);
+
+    std::vector<std::uint32_t> extra(2 * N);
+    std::vector<std::uint8_t> num_extra(N, 0);
+    parallel_chunks(N, num_threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            std::size_t degree = v_offsets[v + 1] - v_offsets[v];
+            if (degree >= 2) continue;
+
+            PhiloxStream rng(seed, VertexDegreeStream, v);
+            std::uint32_t taken = degree == 1 ? v_hyperedges[v_offsets[v]] : std::numeric_limits<std::uint32_t>::max();
+            while (degree + num_extra[v] < 2) {
+                std::uint32_t e = static_cast<std::uint32_t>(rng.next_u64() % E);
+                if (e == taken) continue;
+                extra[2 * v + num_extra[v]++] = e;
+                taken = e;
+            }
+        }
+    });
+
+    H.vertex_offsets.assign(N + 1, 0);
+    for (std::size_t v = 0; v < N; ++v) {
+        H.vertex_offsets[v + 1] = H.vertex_offsets[v] + (v_offsets[v + 1] - v_offsets[v]) + num_extra[v];
+    }
+    H.vertex_hyperedges.resize(H.vertex_offsets[N]);
+    parallel_chunks(N, num_threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            auto row = H.vertex_hyperedges.begin() + H.vertex_offsets[v];
+            auto row_end = std::copy(v_hyperedges.begin() + v_offsets[v], v_hyperedges.begin() + v_offsets[v + 1], row);
+            row_end = std::copy(extra.begin() + 2 * v, extra.begin() + 2 * v + num_extra[v], row_end);
+            if (num_extra[v] > 0) std::sort(row, row_end);
+        }
+    });
+    std::vector<std::size_t>().swap(v_offsets);
+    std::vector<std::uint32_t>().swap(v_hyperedges);
+
+    transpose_incidence_index(H.vertex_offsets, H.vertex_hyperedges, E, num_threads, H.hyperedge_offsets, H.hyperedge_vertices);
+
+    H.vertex_labels.resize(N);
+    parallel_chunks(N, num_threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            H.vertex_labels[v] = random_seed_label(seed, VertexLabelStream, v, 6);
+        }
+    });
+    H.hyperedge_labels.assign(E, std::numeric_limits<std::uint32_t>::max());
 
     return H;
 }
+
+HypergraphSparse generate_hypergraph_sparse(std::size_t N, std::size_t E, double p) {
+    return generate_hypergraph_parallel(N, E, p, 42, 1);
+}
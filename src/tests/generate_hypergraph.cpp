@@ -10,6 +10,7 @@
 #include <string>
 #include "../base_implementation/headers/algorithms.h"
 #include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
 #include <chrono>
 #include <sycl/sycl.hpp>
 #include <unordered_set>
@@ -17,17 +18,6 @@
 
 #include <fstream>
 
-void save_incidence_matrix(const HypergraphNotSparse& H, const std::string& filename) {
-    std::ofstream file(filename);
-    for (const auto& row : H.incidence_matrix) {
-        for (std::size_t j = 0; j < row.size(); ++j) {
-            file << static_cast<int>(row[j]);
-            if (j < row.size() - 1) file << ' ';
-        }
-        file << '\n';
-    }
-}
-
 void save_labels(const std::vector<std::uint32_t>& labels, const std::string& filename) {
     std::ofstream file(filename);
     for (std::size_t i = 0; i < labels.size(); ++i) {
@@ -39,21 +29,34 @@ void save_labels(const std::vector<std::uint32_t>& labels, const std::string& fi
 
 
 int main(int argc, char** argv) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <num_vertices> <num_hyperedges> <probability>" << std::endl;
+    if (argc < 4 || argc > 6) {
+        std::cerr << "Usage: " << argv[0] << " <num_vertices> <num_hyperedges> <probability> [dense|bitset|csr] [output.bin]" << std::endl;
         return 1;
     }
 
     std::size_t N = std::stoul(argv[1]);
     std::size_t E = std::stoul(argv[2]);
     double p = std::stod(argv[3]);
+    std::string layout = argc > 4 ? argv[4] : "dense";
+    std::string output = argc > 5 ? argv[5] : "hypergraph.bin";
 
-    std::cout << "Generazione ipergrafo con distribuzione power-law..." << std::endl;
-    HypergraphNotSparse H = generate_hypergraph(N, E, p);
+    if (layout != "csr" && layout != "dense" && layout != "bitset") {
+        std::cerr << "Unknown layout: " << layout << std::endl;
+        return 1;
+    }
 
-    save_incidence_matrix(H, "incidence_matrix.txt");
+    // Every layout is built from the O(nnz) generator, so the three files hold the same hypergraph.
+    std::cout << "Generazione ipergrafo con distribuzione power-law..." << std::endl;
+    HypergraphSparse H = generate_hypergraph_parallel(N, E, p);
+    if (layout == "csr") {
+        save_hypergraph(H, output);
+    } else if (layout == "bitset") {
+        save_hypergraph(to_bitset(H), output);
+    } else {
+        save_hypergraph(to_dense(H), output);
+    }
     save_labels(H.vertex_labels, "nodes_label.txt");
     save_labels(H.hyperedge_labels, "edges_label.txt");
 
     return 0;
-}
\ No newline at end of file
+}
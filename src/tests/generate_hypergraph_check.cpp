@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/utils.h"
+#include <chrono>
+
+// Structural guarantees of a generated hypergraph: consistent sorted CSR/CSC without duplicates, at least
+// two vertices per hyperedge and two hyperedges per vertex, unlabeled hyperedges and seed labels 0..5 on
+// about 40% of the vertices (within 5 standard deviations). Returns the number of violated guarantees.
+std::size_t check_guarantees(const std::string& name, const HypergraphSparse& H) {
+    const std::size_t N = H.num_vertices, E = H.num_hyperedges;
+    std::size_t failures = 0;
+    auto fail = [&](const std::string& what) {
+        std::cout << name << ": " << what << std::endl;
+        ++failures;
+    };
+
+    std::size_t thin_vertices = 0, thin_hyperedges = 0, unsorted_rows = 0;
+    for (std::size_t v = 0; v < N; ++v) {
+        thin_vertices += H.vertex_offsets[v + 1] - H.vertex_offsets[v] < 2;
+        for (std::size_t k = H.vertex_offsets[v] + 1; k < H.vertex_offsets[v + 1]; ++k) {
+            unsorted_rows += H.vertex_hyperedges[k - 1] >= H.vertex_hyperedges[k];
+        }
+    }
+    for (std::size_t e = 0; e < E; ++e) {
+        thin_hyperedges += H.hyperedge_offsets[e + 1] - H.hyperedge_offsets[e] < 2;
+        for (std::size_t k = H.hyperedge_offsets[e] + 1; k < H.hyperedge_offsets[e + 1]; ++k) {
+            unsorted_rows += H.hyperedge_vertices[k - 1] >= H.hyperedge_vertices[k];
+        }
+    }
+    if (thin_vertices > 0) fail(std::to_string(thin_vertices) + " vertices with fewer than 2 hyperedges");
+    if (thin_hyperedges > 0) fail(std::to_string(thin_hyperedges) + " hyperedges with fewer than 2 vertices");
+    if (unsorted_rows > 0) fail(std::to_string(unsorted_rows) + " unsorted or duplicate row entries");
+
+    HypergraphSparse T = H;
+    build_hyperedge_index(T);
+    if (T.hyperedge_offsets != H.hyperedge_offsets || T.hyperedge_vertices != H.hyperedge_vertices) fail("CSC is not the transpose of the CSR");
+
+    std::size_t labeled = 0, bad_labels = 0;
+    for (std::uint32_t lbl : H.vertex_labels) {
+        if (lbl == std::numeric_limits<std::uint32_t>::max()) continue;
+        ++labeled;
+        bad_labels += lbl > 5;
+    }
+    for (std::uint32_t lbl : H.hyperedge_labels) bad_labels += lbl != std::numeric_limits<std::uint32_t>::max();
+    const double fraction = N == 0 ? 0.4 : static_cast<double>(labeled) / N;
+    if (bad_labels > 0) fail(std::to_string(bad_labels) + " labels outside 0..5 or on hyperedges");
+    if (std::abs(fraction - 0.4) > 5 * std::sqrt(0.24 / std::max<std::size_t>(N, 1))) fail("seeded fraction " + std::to_string(fraction));
+
+    std::cout << name << ": " << H.num_incidences() << " incidences, " << 100 * fraction << "% of the vertices seeded, "
+              << (failures == 0 ? "ok" : "FAILED") << std::endl;
+    return failures;
+}
+
+// The dense and bitset files are converted from the CSR; both must hold exactly its incidences.
+std::size_t check_conversions(const HypergraphSparse& H) {
+    HypergraphSparse D = to_sparse(to_dense(H));
+    HypergraphBitset B = to_bitset(H);
+    std::size_t bits = 0;
+    for (std::uint64_t word : B.incidence_bits) bits += __builtin_popcountll(word);
+
+    bool ok = D.vertex_offsets == H.vertex_offsets && D.vertex_hyperedges == H.vertex_hyperedges && D.vertex_labels == H.vertex_labels
+              && bits == H.num_incidences();
+    std::cout << "Dense and bitset conversions: " << (ok ? "ok" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <num_vertices> <num_hyperedges> <probability>" << std::endl;
+        return 1;
+    }
+
+    std::size_t N = std::stoul(argv[1]);
+    std::size_t E = std::stoul(argv[2]);
+    double p = std::stod(argv[3]);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    HypergraphSparse S = generate_hypergraph_sparse(N, E, p);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "1 thread (ms): " << std::chrono::duration<double, std::milli>(end - start).count() << std::endl;
+    std::size_t failures = check_guarantees("generate_hypergraph_sparse", S) + check_conversions(S);
+
+    // The output must not depend on the thread count (0 = all hardware threads).
+    for (unsigned num_threads : {2u, 3u, 7u, 0u}) {
+        start = std::chrono::high_resolution_clock::now();
+        HypergraphSparse P = generate_hypergraph_parallel(N, E, p, 42, num_threads);
+        end = std::chrono::high_resolution_clock::now();
+        bool same = P.vertex_offsets == S.vertex_offsets && P.vertex_hyperedges == S.vertex_hyperedges
+                    && P.hyperedge_offsets == S.hyperedge_offsets && P.hyperedge_vertices == S.hyperedge_vertices
+                    && P.vertex_labels == S.vertex_labels && P.hyperedge_labels == S.hyperedge_labels;
+        std::cout << num_threads << (num_threads == 0 ? " (all)" : "") << " threads (ms): "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << ", " << (same ? "identical" : "DIFFERS") << std::endl;
+        failures += !same;
+    }
+    return failures == 0 ? 0 : 1;
+}
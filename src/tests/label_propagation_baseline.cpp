@@ -10,20 +10,18 @@
 #include <string>
 #include "../base_implementation/headers/algorithms.h"
 #include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
 #include <chrono>
 #include <sycl/sycl.hpp>
 
 int main(int argc, char** argv) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <num_vertices> <num_hyperedges> <probability>" << std::endl;
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [seed_labels.txt]" << std::endl;
         return 1;
     }
 
-    std::size_t num_vertices = std::stoul(argv[1]);
-    std::size_t num_hyperedges = std::stoul(argv[2]);
-    double probability = std::stod(argv[3]);
-
-    HypergraphNotSparse H = generate_hypergraph(num_vertices, num_hyperedges, probability);
+    HypergraphNotSparse H = load_hypergraph_dense(argv[1]);
+    if (argc == 3) read_seed_labels(argv[2], H.vertex_labels);
 
     find_communities(H);
 
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include "../base_implementation/headers/philox.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Propagates batch_size seed sets in one batched run, then one after the other with run(), and compares
+// the labels, the iteration counts and the time per instance.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [batch_size] [num_labels]" << std::endl;
+        return 1;
+    }
+
+    HypergraphSparse H = load_hypergraph_sparse(argv[1]);
+    std::size_t batch_size = argc >= 3 ? std::stoul(argv[2]) : 16;
+    std::uint32_t num_labels = argc >= 4 ? static_cast<std::uint32_t>(std::stoul(argv[3])) : 6;
+
+    std::vector<std::vector<std::uint32_t>> seed_sets(batch_size);
+    for (std::size_t b = 0; b < batch_size; ++b) seed_sets[b] = random_seed_labels(H.num_vertices, b + 1, num_labels);
+
+    LabelPropagationEngine engine(H);
+    LabelPropagationOptions options;
+    options.label_counting = LabelCounting::Histogram;
+
+    auto batch_start = std::chrono::high_resolution_clock::now();
+    std::vector<LabelPropagationResult> batched = engine.run_batch(seed_sets, options);
+    auto batch_end = std::chrono::high_resolution_clock::now();
+    double batch_ms = std::chrono::duration<double, std::milli>(batch_end - batch_start).count();
+
+    std::size_t sweeps = 0;
+    for (const LabelPropagationResult& result : batched) sweeps = std::max(sweeps, result.iterations);
+    std::cout << "Batched: " << batch_size << " instances, " << sweeps << " sweeps, propagation (ms): " << batched[0].time_ms
+              << ", total (ms): " << batch_ms << ", per instance (ms): " << batch_ms / batch_size << std::endl;
+
+    double single_ms = 0;
+    std::size_t single_sweeps = 0;
+    std::size_t mismatches = 0;
+    bool same_iterations = true;
+    for (std::size_t b = 0; b < batch_size; ++b) {
+        auto run_start = std::chrono::high_resolution_clock::now();
+        LabelPropagationResult result = engine.run(seed_sets[b], options);
+        auto run_end = std::chrono::high_resolution_clock::now();
+        single_ms += std::chrono::duration<double, std::milli>(run_end - run_start).count();
+        single_sweeps += result.iterations;
+
+        mismatches += result.vertex_labels != batched[b].vertex_labels;
+        mismatches += result.hyperedge_labels != batched[b].hyperedge_labels;
+        same_iterations = same_iterations && result.iterations == batched[b].iterations;
+    }
+    std::cout << "One by one: " << single_sweeps << " sweeps, total (ms): " << single_ms << ", per instance (ms): " << single_ms / batch_size
+              << ", speedup: " << single_ms / batch_ms << std::endl;
+
+    // Index traffic of the incidence structure (offsets and indices of both directions) over all sweeps.
+    double structure_mb = ((H.num_vertices + H.num_hyperedges + 2) * sizeof(std::size_t) + 2 * H.num_incidences() * sizeof(std::uint32_t)) / 1e6;
+    std::cout << "Incidence structure read (MB): batched " << structure_mb * sweeps << ", one by one " << structure_mb * single_sweeps << std::endl;
+
+    std::cout << "Mismatching instances: " << mismatches << (same_iterations ? "" : ", iteration counts differ") << std::endl;
+    return mismatches == 0 && same_iterations ? 0 : 1;
+}
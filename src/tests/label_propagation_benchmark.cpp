@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../base_implementation/headers/algorithms.h"
+#include "../base_implementation/headers/cpu_backend.h"
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/philox.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Sweeps every combination of the listed sizes, densities, label counts, data types and variants.
+//   --vertices=1000,2000 --hyperedges=10000,20000 --density=0.01,0.1 --labels=6,16
+//   --types=uint32,narrow        narrow runs find_communities_dispatch (dense variants only)
+//   --variants=baseline,transpose,bitset,sparse,colored,cpu   colored is the sparse engine with SweepOrder::Colored,
+//                                cpu is the native backend (find_communities_cpu)
+//   --incidence=pageable         dense matrix memory: pageable, host (USM host) or shared (USM shared)
+//   --warmup=1 --reps=5 --json=results.json --csv=results.csv
+struct BenchmarkConfig
+{
+    std::vector<std::size_t> vertices = {1000};
+    std::vector<std::size_t> hyperedges = {10000};
+    std::vector<double> densities = {0.05};
+    std::vector<std::uint32_t> labels = {6};
+    std::vector<std::string> types = {"uint32"};
+    std::vector<std::string> variants = {"baseline", "transpose", "bitset", "sparse", "colored", "cpu"};
+    std::string incidence = "pageable";
+    std::size_t warmup = 1;
+    std::size_t reps = 5;
+    std::string json_path;
+    std::string csv_path;
+};
+
+struct Summary
+{
+    double median = 0;
+    double p95 = 0;
+};
+
+struct BenchmarkRecord
+{
+    std::string variant;
+    std::string type;
+    std::size_t N, E, nnz;
+    double density;
+    std::uint32_t labels;
+    std::size_t iterations;
+    Summary generate, flatten, upload, transpose, iteration, download;
+    double gbps;   // bytes one sweep touches / median time per iteration
+};
+
+std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream ss(value);
+    for (std::string item; std::getline(ss, item, ',');) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+template <typename T>
+std::vector<T> parse_list(const std::string& value, T (*parse)(const std::string&)) {
+    std::vector<T> out;
+    for (const std::string& item : split_list(value)) out.push_back(parse(item));
+    return out;
+}
+
+bool parse_args(int argc, char** argv, BenchmarkConfig& config) {
+    auto to_size = [](const std::string& s) -> std::size_t { return std::stoul(s); };
+    auto to_u32 = [](const std::string& s) -> std::uint32_t { return static_cast<std::uint32_t>(std::stoul(s)); };
+    auto to_double = [](const std::string& s) -> double { return std::stod(s); };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) return false;
+        std::string key = arg.substr(2, eq - 2), value = arg.substr(eq + 1);
+
+        if (key == "vertices") config.vertices = parse_list<std::size_t>(value, to_size);
+        else if (key == "hyperedges") config.hyperedges = parse_list<std::size_t>(value, to_size);
+        else if (key == "density") config.densities = parse_list<double>(value, to_double);
+        else if (key == "labels") config.labels = parse_list<std::uint32_t>(value, to_u32);
+        else if (key == "types") config.types = split_list(value);
+        else if (key == "variants") config.variants = split_list(value);
+        else if (key == "incidence") config.incidence = value;
+        else if (key == "warmup") config.warmup = std::stoul(value);
+        else if (key == "reps") config.reps = std::max<std::size_t>(1, std::stoul(value));
+        else if (key == "json") config.json_path = value;
+        else if (key == "csv") config.csv_path = value;
+        else return false;
+    }
+    return config.incidence == "pageable" || config.incidence == "host" || config.incidence == "shared";
+}
+
+// Nearest-rank percentiles.
+Summary summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<std::size_t>(std::ceil(q * samples.size())) - 1)]; };
+    return {rank(0.5), rank(0.95)};
+}
+
+// Same seeding rule as the generators (40% of the vertices), with labels 0..num_labels-1. The stream seed
+// is fixed, so every label count reseeds the same vertices.
+void reseed_labels(HypergraphNotSparse& H, std::uint32_t num_labels) {
+    H.vertex_labels = random_seed_labels(H.num_vertices, 1, num_labels);
+    std::fill(H.hyperedge_labels.begin(), H.hyperedge_labels.end(), std::numeric_limits<std::uint32_t>::max());
+}
+
+// Bytes one sweep (hyperedge phase + vertex phase) reads: the incidence structure of both phases and
+// one label gather per incidence.
+double bytes_per_sweep(const std::string& variant, const HypergraphNotSparse& H, std::size_t nnz, std::size_t label_bytes, std::size_t incidence_bytes) {
+    const double N = H.num_vertices, E = H.num_hyperedges;
+    const double gathers = 2.0 * nnz * label_bytes;
+    if (variant == "bitset") return 2.0 * N * E / 8 + gathers;
+    if (variant == "sparse" || variant == "colored" || variant == "cpu") return 2.0 * nnz * sizeof(std::uint32_t) + (N + E + 2) * sizeof(std::size_t) + gathers;
+    return 2.0 * N * E * incidence_bytes + gathers;
+}
+
+bool is_dense(const std::string& variant) {
+    return variant == "baseline" || variant == "transpose";
+}
+
+// Prepares the variant's layout (timed as flatten when it is built outside find_communities*) and runs it.
+PhaseTimings run_variant(const std::string& variant, const std::string& type, const HypergraphNotSparse& H) {
+    PhaseTimings timings;
+    if (is_dense(variant)) {
+        HypergraphNotSparse copy = H;
+        if (type == "narrow") {
+            find_communities_dispatch(copy, variant == "transpose", &timings);
+        } else if (variant == "transpose") {
+            find_communities_transpose(copy, &timings);
+        } else {
+            find_communities(copy, &timings);
+        }
+    } else if (variant == "bitset") {
+        auto start = std::chrono::high_resolution_clock::now();
+        HypergraphBitset B = to_bitset(H);
+        double flatten_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        find_communities_bitset(B, &timings);
+        timings.flatten_ms = flatten_ms;
+    } else if (variant == "cpu") {
+        HypergraphNotSparse copy = H;
+        find_communities_cpu(copy, &timings);
+    } else if (variant == "colored") {
+        auto start = std::chrono::high_resolution_clock::now();
+        HypergraphSparse S = to_sparse(H);
+        double flatten_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        LabelPropagationEngine engine(S);
+        double upload_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LabelPropagationOptions options;
+        options.sweep_order = SweepOrder::Colored;
+        start = std::chrono::high_resolution_clock::now();
+        LabelPropagationResult result = engine.run(S.vertex_labels, options);
+        double run_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        timings = {flatten_ms, upload_ms, 0, result.time_ms, run_ms - result.time_ms, result.iterations};
+    } else {
+        auto start = std::chrono::high_resolution_clock::now();
+        HypergraphSparse S = to_sparse(H);
+        double flatten_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        find_communities_sparse(S, &timings);
+        timings.flatten_ms = flatten_ms;
+    }
+    return timings;
+}
+
+void write_json(const std::string& path, const std::vector<BenchmarkRecord>& records) {
+    std::ofstream out(path);
+    auto summary = [&](const char* name, const Summary& s) {
+        out << "\"" << name << "_ms\": {\"median\": " << s.median << ", \"p95\": " << s.p95 << "}";
+    };
+    out << "[\n";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const BenchmarkRecord& r = records[i];
+        out << "  {\"variant\": \"" << r.variant << "\", \"type\": \"" << r.type << "\", \"vertices\": " << r.N
+            << ", \"hyperedges\": " << r.E << ", \"density\": " << r.density << ", \"labels\": " << r.labels
+            << ", \"incidences\": " << r.nnz << ", \"iterations\": " << r.iterations << ", ";
+        summary("generate", r.generate);
+        out << ", ";
+        summary("flatten", r.flatten);
+        out << ", ";
+        summary("h2d", r.upload);
+        out << ", ";
+        summary("transpose", r.transpose);
+        out << ", ";
+        summary("iteration", r.iteration);
+        out << ", ";
+        summary("d2h", r.download);
+        out << ", \"gbps\": " << r.gbps << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+void write_csv(const std::string& path, const std::vector<BenchmarkRecord>& records) {
+    std::ofstream out(path);
+    out << "variant,type,vertices,hyperedges,density,labels,incidences,iterations";
+    for (const char* phase : {"generate", "flatten", "h2d", "transpose", "iteration", "d2h"}) {
+        out << "," << phase << "_median_ms," << phase << "_p95_ms";
+    }
+    out << ",gbps\n";
+    for (const BenchmarkRecord& r : records) {
+        out << r.variant << "," << r.type << "," << r.N << "," << r.E << "," << r.density << "," << r.labels << ","
+            << r.nnz << "," << r.iterations;
+        for (const Summary* s : {&r.generate, &r.flatten, &r.upload, &r.transpose, &r.iteration, &r.download}) {
+            out << "," << s->median << "," << s->p95;
+        }
+        out << "," << r.gbps << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    if (!parse_args(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--vertices=N,...] [--hyperedges=E,...] [--density=p,...] [--labels=L,...]"
+                  << " [--types=uint32,narrow] [--variants=baseline,transpose,bitset,sparse,colored,cpu]"
+                  << " [--incidence=pageable|host|shared] [--warmup=1] [--reps=5] [--json=path] [--csv=path]" << std::endl;
+        return 1;
+    }
+
+    IncidenceAllocation allocation;
+    if (config.incidence != "pageable") {
+        sycl::queue q(preferred_device());
+        allocation = usm_incidence_allocation(q, config.incidence == "host" ? sycl::usm::alloc::host : sycl::usm::alloc::shared);
+    }
+
+    std::vector<BenchmarkRecord> records;
+    for (std::size_t N : config.vertices)
+    for (std::size_t E : config.hyperedges)
+    for (double density : config.densities) {
+        auto generate_start = std::chrono::high_resolution_clock::now();
+        // O(nnz) generation; only the dense matrix the variants read is N x E.
+        HypergraphNotSparse H;
+        std::size_t nnz;
+        {
+            HypergraphSparse S = generate_hypergraph_parallel(N, E, density);
+            nnz = S.num_incidences();
+            H = to_dense(S, allocation);
+        }
+        double generate_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - generate_start).count();
+
+        for (std::uint32_t num_labels : config.labels) {
+            reseed_labels(H, num_labels);
+            DenseTypeSelection narrow_types = select_dense_types(H);
+
+            for (const std::string& variant : config.variants)
+            for (const std::string& type : config.types) {
+                if (type == "narrow" && !is_dense(variant)) continue;
+
+                for (std::size_t i = 0; i < config.warmup; ++i) run_variant(variant, type, H);
+
+                std::vector<double> flatten, upload, transpose, iteration, download;
+                std::size_t iterations = 0;
+                for (std::size_t i = 0; i < config.reps; ++i) {
+                    PhaseTimings t = run_variant(variant, type, H);
+                    iterations = t.iterations;
+                    flatten.push_back(t.flatten_ms);
+                    upload.push_back(t.upload_ms);
+                    transpose.push_back(t.transpose_ms);
+                    iteration.push_back(t.propagate_ms / std::max<std::size_t>(t.iterations, 1));
+                    download.push_back(t.download_ms);
+                }
+
+                BenchmarkRecord r;
+                r.variant = variant;
+                r.type = type;
+                r.N = N;
+                r.E = E;
+                r.nnz = nnz;
+                r.density = density;
+                r.labels = num_labels;
+                r.iterations = iterations;
+                r.generate = {generate_ms, generate_ms};
+                r.flatten = summarize(flatten);
+                r.upload = summarize(upload);
+                r.transpose = summarize(transpose);
+                r.iteration = summarize(iteration);
+                r.download = summarize(download);
+
+                bool narrow = type == "narrow";
+                double bytes = bytes_per_sweep(variant, H, nnz, narrow ? narrow_types.label_bytes : sizeof(std::uint32_t),
+                                               narrow ? narrow_types.incidence_bytes : sizeof(std::uint32_t));
+                r.gbps = r.iteration.median > 0 ? bytes / (r.iteration.median * 1e6) : 0;
+                records.push_back(r);
+
+                std::cout << variant << " (" << type << ") N=" << N << " E=" << E << " p=" << density << " labels=" << num_labels
+                          << ": " << iterations << " iterations, per iteration (ms) median " << r.iteration.median
+                          << " p95 " << r.iteration.p95 << ", H2D (ms) " << r.upload.median
+                          << ", transpose (ms) " << r.transpose.median << ", D2H (ms) " << r.download.median
+                          << ", " << r.gbps << " GB/s" << std::endl;
+            }
+        }
+    }
+
+    if (!config.json_path.empty()) write_json(config.json_path, records);
+    if (!config.csv_path.empty()) write_csv(config.csv_path, records);
+    return 0;
+}
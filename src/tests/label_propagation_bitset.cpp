@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/algorithms.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [seed_labels.txt]" << std::endl;
+        return 1;
+    }
+
+    HypergraphNotSparse H = load_hypergraph_dense(argv[1]);
+    if (argc == 3) read_seed_labels(argv[2], H.vertex_labels);
+    HypergraphBitset B = load_hypergraph_bitset(argv[1]);
+    if (argc == 3) read_seed_labels(argv[2], B.vertex_labels);
+
+    std::cout << std::endl << "Bitset Label Propagation (" << B.words_per_row << " words per row):" << std::endl;
+    find_communities_bitset(B);
+    std::cout << "Done." << std::endl;
+
+    std::cout << std::endl << "Baseline Label Propagation:" << std::endl;
+    find_communities(H);
+    std::cout << "Done." << std::endl;
+
+    std::size_t mismatches = 0;
+    for (size_t i = 0; i < H.vertex_labels.size(); ++i) {
+        if (H.vertex_labels[i] != B.vertex_labels[i]) {
+            if (mismatches == 0) {
+                std::cout << "v" << i << ": " << static_cast<int>(H.vertex_labels[i]) << " != " << static_cast<int>(B.vertex_labels[i]) << "\n";
+            }
+            mismatches++;
+        }
+    }
+    std::cout << "Vertex label mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
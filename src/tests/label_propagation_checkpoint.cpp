@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/checkpoint.h"
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Interrupts a run after stop_after sweeps, resumes it from the checkpoint file and compares the result
+// with an uninterrupted run; then warm-starts a run from the converged labels. Finally the run is stopped
+// after every sweep in turn, inside convergence-check batches and past convergence, and resumed each time.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 6) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [checkpoint_path] [checkpoint_interval] [stop_after] [full|active]" << std::endl;
+        return 1;
+    }
+
+    HypergraphSparse H = load_hypergraph_sparse(argv[1]);
+    std::string path = argc >= 3 ? argv[2] : "labels.ckpt";
+    std::size_t interval = argc >= 4 ? std::stoul(argv[3]) : 1;
+    std::size_t stop_after = argc >= 5 ? std::stoul(argv[4]) : 2;
+
+    LabelPropagationOptions options;
+    options.active_set = argc == 6 && std::string(argv[5]) == "active";
+    LabelPropagationEngine engine(H);
+
+    LabelPropagationResult reference = engine.run(H.vertex_labels, options);
+    std::cout << "Uninterrupted run: " << reference.iterations << " iterations, propagation (ms): " << reference.time_ms << std::endl;
+
+    LabelPropagationOptions checkpointed = options;
+    checkpointed.checkpoint_interval = interval;
+    checkpointed.checkpoint_path = path;
+    LabelPropagationResult with_checkpoints = engine.run(H.vertex_labels, checkpointed);
+    std::cout << "With checkpoints every " << interval << " sweeps: " << with_checkpoints.checkpoints << " written, propagation (ms): "
+              << with_checkpoints.time_ms << std::endl;
+
+    // A run "killed" after stop_after sweeps leaves its last checkpoint behind.
+    LabelPropagationOptions interrupted = checkpointed;
+    interrupted.max_iterations = stop_after;
+    engine.run(H.vertex_labels, interrupted);
+
+    LabelCheckpoint checkpoint = load_checkpoint(path);
+    LabelPropagationResult resumed = engine.resume(checkpoint, options);
+    std::cout << "Resumed from sweep " << checkpoint.iteration << (checkpoint.converged ? " (converged)" : "") << ": "
+              << resumed.iterations << " iterations, propagation (ms): " << resumed.time_ms << std::endl;
+
+    LabelPropagationResult warm = engine.resume({0, false, reference.vertex_labels, reference.hyperedge_labels}, options);
+    std::cout << "Warm start from the converged labels: " << warm.iterations << " iterations" << std::endl;
+
+    std::size_t mismatches = 0;
+    for (std::size_t v = 0; v < H.num_vertices; ++v) mismatches += resumed.vertex_labels[v] != reference.vertex_labels[v];
+    for (std::size_t e = 0; e < H.num_hyperedges; ++e) mismatches += resumed.hyperedge_labels[e] != reference.hyperedge_labels[e];
+    mismatches += with_checkpoints.vertex_labels != reference.vertex_labels;
+    mismatches += warm.vertex_labels != reference.vertex_labels;
+    bool same_iterations = resumed.iterations == reference.iterations && warm.iterations == 1;
+
+    std::size_t bad_resumes = 0;
+    for (std::size_t stop = 1; stop <= reference.iterations + ConvergenceCheckInterval; ++stop) {
+        LabelPropagationOptions cut = checkpointed;
+        cut.max_iterations = stop;
+        engine.run(H.vertex_labels, cut);
+        LabelPropagationResult r = engine.resume(load_checkpoint(path), options);
+        bad_resumes += r.iterations != reference.iterations || r.vertex_labels != reference.vertex_labels;
+    }
+    std::cout << "Resumed after every sweep up to " << reference.iterations + ConvergenceCheckInterval << ": " << bad_resumes
+              << " runs differ from the uninterrupted one" << std::endl;
+    same_iterations = same_iterations && bad_resumes == 0;
+
+    std::cout << "Label mismatches: " << mismatches << (same_iterations ? "" : ", iteration counts differ") << std::endl;
+
+    return mismatches == 0 && same_iterations ? 0 : 1;
+}
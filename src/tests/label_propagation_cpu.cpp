@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/algorithms.h"
+#include "../base_implementation/headers/cpu_backend.h"
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Runs the native CPU backend and the SYCL baseline (on a GPU, or the SYCL CPU device as fallback)
+// on the same hypergraph and compares their labels.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [seed_labels.txt] [num_threads]" << std::endl;
+        return 1;
+    }
+
+    HypergraphNotSparse H = load_hypergraph_dense(argv[1]);
+    if (argc >= 3 && std::string(argv[2]) != "-") read_seed_labels(argv[2], H.vertex_labels);
+    unsigned num_threads = argc == 4 ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+    HypergraphNotSparse H_cpu = H;
+
+    std::cout << std::endl << "Native CPU Label Propagation:" << std::endl;
+    find_communities_cpu(H_cpu, nullptr, num_threads);
+    std::cout << "Done." << std::endl;
+
+    std::cout << std::endl << "Baseline Label Propagation on " << preferred_device().get_info<sycl::info::device::name>() << ":" << std::endl;
+    find_communities(H);
+    std::cout << "Done." << std::endl;
+
+    std::size_t mismatches = 0;
+    for (size_t i = 0; i < H.vertex_labels.size(); ++i) {
+        if (H.vertex_labels[i] != H_cpu.vertex_labels[i]) {
+            if (mismatches == 0) {
+                std::cout << "v" << i << ": " << static_cast<int>(H.vertex_labels[i]) << " != " << static_cast<int>(H_cpu.vertex_labels[i]) << "\n";
+            }
+            mismatches++;
+        }
+    }
+    for (size_t e = 0; e < H.hyperedge_labels.size(); ++e) mismatches += H.hyperedge_labels[e] != H_cpu.hyperedge_labels[e];
+    std::cout << "Label mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
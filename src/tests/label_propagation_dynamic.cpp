@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/dynamic.h"
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include "../base_implementation/headers/philox.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// A random batch of batch_size changes: half added and half removed incidences (the removed ones drawn
+// from the original structure), one new vertex with two hyperedges, one new hyperedge with three
+// vertices, and on every fourth batch one removed vertex and one removed hyperedge, plus additions and
+// removals of ids past the new ones, which must be no-ops.
+HypergraphUpdate random_batch(const HypergraphSparse& H, std::size_t N, std::size_t E, std::size_t batch_size, std::uint64_t seed) {
+    PhiloxStream rng(seed, 1, 0);
+    auto pick = [&rng](std::size_t n) { return static_cast<std::uint32_t>(rng.next_unit() * n); };
+
+    HypergraphUpdate batch;
+    for (std::size_t i = 0; i < batch_size / 2; ++i) {
+        batch.added_incidences.push_back({pick(N), pick(E)});
+
+        std::uint32_t v = pick(H.num_vertices);
+        std::size_t degree = H.vertex_offsets[v + 1] - H.vertex_offsets[v];
+        if (degree > 0) batch.removed_incidences.push_back({v, H.vertex_hyperedges[H.vertex_offsets[v] + pick(degree)]});
+    }
+
+    batch.added_vertex_labels.push_back(pick(6));
+    batch.added_incidences.push_back({static_cast<std::uint32_t>(N), pick(E)});
+    batch.added_incidences.push_back({static_cast<std::uint32_t>(N), pick(E)});
+    batch.added_hyperedges.push_back({pick(N), pick(N), pick(N)});
+
+    if (seed % 4 == 3) {
+        batch.removed_vertices.push_back(pick(N));
+        batch.removed_hyperedges.push_back(pick(E));
+        batch.added_incidences.push_back({static_cast<std::uint32_t>(N + 1), pick(E)});
+        batch.added_incidences.push_back({pick(N), static_cast<std::uint32_t>(E + 1)});
+        batch.removed_incidences.push_back({static_cast<std::uint32_t>(N + 1), pick(E)});
+        batch.removed_incidences.push_back({pick(N), static_cast<std::uint32_t>(E + 1)});
+        batch.removed_vertices.push_back(static_cast<std::uint32_t>(N + 1));
+        batch.removed_hyperedges.push_back(static_cast<std::uint32_t>(E + 1));
+    }
+    return batch;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [num_batches] [batch_size] [check]" << std::endl;
+        return 1;
+    }
+
+    HypergraphSparse H = load_hypergraph_sparse(argv[1]);
+    std::size_t num_batches = argc >= 3 ? std::stoul(argv[2]) : 10;
+    std::size_t batch_size = argc >= 4 ? std::stoul(argv[3]) : 100;
+    bool check = argc == 5 && std::string(argv[4]) == "check";
+
+    LabelPropagationOptions options;
+    options.active_set = true;
+
+    auto setup_start = std::chrono::high_resolution_clock::now();
+    DynamicLabelPropagation dynamic(H);
+    auto setup_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Dynamic setup (ms): " << std::chrono::duration<double, std::milli>(setup_end - setup_start).count() << std::endl;
+
+    DynamicResult initial = dynamic.run(H.vertex_labels, options);
+    std::cout << "Initial run: " << initial.iterations << " iterations, rows processed: " << initial.rows_processed
+              << ", propagation (ms): " << initial.time_ms << std::endl;
+
+    // Seeds of a from-scratch rerun on the current structure.
+    std::vector<std::uint32_t> seeds = H.vertex_labels;
+    std::size_t failures = 0;
+
+    for (std::size_t b = 0; b < num_batches; ++b) {
+        HypergraphUpdate batch = random_batch(H, dynamic.num_vertices(), dynamic.num_hyperedges(), batch_size, b);
+        seeds.insert(seeds.end(), batch.added_vertex_labels.begin(), batch.added_vertex_labels.end());
+        for (std::uint32_t v : batch.removed_vertices) {
+            if (v < seeds.size()) seeds[v] = std::numeric_limits<std::uint32_t>::max();
+        }
+
+        DynamicResult result = dynamic.update(batch);
+        std::cout << "Batch " << b << ": apply (ms): " << result.apply_ms << ", propagation (ms): " << result.time_ms
+                  << ", " << result.iterations << " iterations" << (result.converged ? "" : " (not converged)")
+                  << ", rows processed: " << result.rows_processed << ", incidences: " << dynamic.num_incidences() << std::endl;
+
+        if (check) {
+            // The labels must be a fixed point: the engine, started from them, changes nothing.
+            HypergraphSparse S = dynamic.snapshot();
+            LabelPropagationEngine engine(S);
+            LabelPropagationResult rerun = engine.run(S.vertex_labels, options);
+            bool fixed_point = rerun.iterations == 1 && rerun.vertex_labels == S.vertex_labels && rerun.hyperedge_labels == S.hyperedge_labels;
+            if (!fixed_point) {
+                std::cout << "Batch " << b << ": labels are not a fixed point" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    HypergraphSparse S = dynamic.snapshot();
+    auto rerun_start = std::chrono::high_resolution_clock::now();
+    LabelPropagationEngine engine(S);
+    LabelPropagationResult rerun = engine.run(seeds, options);
+    auto rerun_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Full rerun: " << rerun.iterations << " iterations, propagation (ms): " << rerun.time_ms
+              << ", total (ms): " << std::chrono::duration<double, std::milli>(rerun_end - rerun_start).count() << std::endl;
+
+    if (check) std::cout << "Fixed-point failures: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include "../base_implementation/headers/philox.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+RowMapping parse_mapping(const std::string& name) {
+    if (name == "item") return RowMapping::WorkItem;
+    if (name == "subgroup") return RowMapping::SubGroup;
+    if (name == "workgroup") return RowMapping::WorkGroup;
+    if (name == "binned") return RowMapping::Binned;
+    if (name == "mergepath") return RowMapping::MergePath;
+    return RowMapping::Auto;
+}
+
+LabelCounting parse_counting(const std::string& name) {
+    if (name == "histogram") return LabelCounting::Histogram;
+    if (name == "sparse") return LabelCounting::Sparse;
+    return LabelCounting::Auto;
+}
+
+const char* termination_name(Termination termination) {
+    switch (termination) {
+    case Termination::Converged: return "converged";
+    case Termination::Oscillation: return "oscillation";
+    case Termination::Plateau: return "plateau";
+    default: return "max iterations";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 8) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [num_runs] [full|active|colored] [auto|item|subgroup|workgroup|binned|mergepath]"
+                  << " [num_labels] [auto|histogram|sparse] [detect]" << std::endl;
+        return 1;
+    }
+
+    HypergraphSparse H = load_hypergraph_sparse(argv[1]);
+    std::size_t num_runs = argc >= 3 ? std::stoul(argv[2]) : 5;
+
+    LabelPropagationOptions options;
+    options.active_set = argc >= 4 && std::string(argv[3]) == "active";
+    if (argc >= 4 && std::string(argv[3]) == "colored") {
+        options.sweep_order = SweepOrder::Colored;
+    }
+    if (argc >= 5) {
+        options.hyperedge_mapping = options.vertex_mapping = parse_mapping(argv[4]);
+    }
+    std::uint32_t num_labels = argc >= 6 ? static_cast<std::uint32_t>(std::stoul(argv[5])) : 6;
+    if (argc >= 7) {
+        options.label_counting = parse_counting(argv[6]);
+    }
+    // Stop on 2-cycles, and after 5 sweeps in a row that each change at most 0.1% of the vertices (at least one).
+    bool detect = argc == 8 && std::string(argv[7]) == "detect";
+    if (detect) {
+        options.detect_oscillation = true;
+        options.plateau_iterations = 5;
+    }
+
+    auto setup_start = std::chrono::high_resolution_clock::now();
+    LabelPropagationEngine engine(H);
+    auto setup_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Engine setup (ms): " << std::chrono::duration<double, std::milli>(setup_end - setup_start).count() << std::endl;
+
+    for (std::size_t run = 0; run < num_runs; ++run) {
+        std::vector<std::uint32_t> seeds = run == 0 ? H.vertex_labels : random_seed_labels(H.num_vertices, run, num_labels);
+
+        auto run_start = std::chrono::high_resolution_clock::now();
+        LabelPropagationResult result = engine.run(seeds, options);
+        auto run_end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Run " << run << ": " << result.iterations << " iterations (" << termination_name(result.termination) << ")"
+                  << ", " << (result.label_counting == LabelCounting::Sparse ? "sparse" : "histogram") << " counting"
+                  << (options.sweep_order == SweepOrder::Colored ? ", " + std::to_string(result.overflow_vertices) + " overflow vertices" : "")
+                  << ", propagation (ms): " << result.time_ms
+                  << ", throughput (M incidences/s): " << 2.0 * engine.num_incidences() * result.iterations / (result.time_ms * 1e3)
+                  << ", total (ms): " << std::chrono::duration<double, std::milli>(run_end - run_start).count() << std::endl;
+    }
+
+    if (!detect) return 0;
+
+    // Plateau check: with a threshold every sweep meets, the run must stop after plateau_iterations
+    // changing sweeps, with the labels of a run cut off at that sweep.
+    std::vector<std::uint32_t> seeds = random_seed_labels(H.num_vertices, 1, num_labels);
+    LabelPropagationOptions plain = options;
+    plain.detect_oscillation = false;
+    plain.plateau_iterations = 0;
+    plain.convergence_check_interval = 1;
+    LabelPropagationResult reference = engine.run(seeds, plain);
+    if (reference.iterations <= 2) {
+        std::cout << "Plateau check skipped: converged after " << reference.iterations << " sweeps" << std::endl;
+        return 0;
+    }
+
+    LabelPropagationOptions plateau = plain;
+    plateau.plateau_iterations = 2;
+    plateau.plateau_fraction = 1.0;
+    LabelPropagationResult stopped = engine.run(seeds, plateau);
+    LabelPropagationOptions cut = plain;
+    cut.max_iterations = 2;
+    LabelPropagationResult expected = engine.run(seeds, cut);
+
+    bool ok = stopped.termination == Termination::Plateau && stopped.iterations == 2 && stopped.vertex_labels == expected.vertex_labels;
+    std::cout << "Plateau check: " << stopped.iterations << " iterations (" << termination_name(stopped.termination) << ")"
+              << (ok ? "" : ", expected a plateau after 2 sweeps with the labels of a 2-sweep run") << std::endl;
+    return ok ? 0 : 1;
+}
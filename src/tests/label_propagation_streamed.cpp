@@ -0,0 +1,67 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "../base_implementation/headers/engine.h"
+#include "../base_implementation/headers/streamed.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Streams the incidence tiles straight from the mapped file when it is a CSR hypergraph file, otherwise
+// from a hypergraph loaded into host memory. With "check" the labels are compared with the in-core engine,
+// which loads its own copy of the hypergraph.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [tile_incidences] [check]" << std::endl;
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    std::size_t tile_incidences = argc >= 3 ? std::stoul(argv[2]) : 0;
+    bool check = argc == 4 && std::string(argv[3]) == "check";
+
+    std::unique_ptr<MappedHypergraph> mapped;
+    HypergraphSparse H;
+    IncidenceSource source;
+    std::vector<std::uint32_t> seeds;
+
+    bool text = path.size() >= 4 && (path.compare(path.size() - 4, 4, ".hgr") == 0 || path.compare(path.size() - 4, 4, ".mtx") == 0);
+    if (!text) mapped = std::make_unique<MappedHypergraph>(path);
+    if (mapped && mapped->layout() == HypergraphLayout::CSR) {
+        source = incidence_source(*mapped);
+        mapped->read_vertex_labels(seeds);
+        std::cout << "Streaming from the mapped file" << std::endl;
+    } else {
+        mapped.reset();
+        H = load_hypergraph_sparse(path);
+        source = incidence_source(H);
+        seeds = H.vertex_labels;
+        std::cout << "Streaming from host memory" << std::endl;
+    }
+
+    StreamedLabelPropagation streamed(source, tile_incidences);
+    StreamedResult result = streamed.run(seeds);
+    std::cout << "Streamed: " << result.iterations << " iterations" << (result.converged ? "" : " (not converged)")
+              << ", tile capacity: " << streamed.tile_capacity() << " incidences"
+              << ", tiles per iteration: " << result.tiles_per_iteration
+              << ", streamed (MB): " << result.bytes_streamed / 1e6
+              << ", propagation (ms): " << result.time_ms
+              << ", throughput (M incidences/s): " << 2.0 * streamed.num_incidences() * result.iterations / (result.time_ms * 1e3) << std::endl;
+
+    if (!check) return 0;
+
+    if (mapped) H = load_hypergraph_sparse(path);
+    LabelPropagationEngine engine(H);
+    LabelPropagationResult reference = engine.run(seeds);
+    std::cout << "Engine: " << reference.iterations << " iterations, propagation (ms): " << reference.time_ms << std::endl;
+
+    std::size_t mismatches = 0;
+    for (std::size_t v = 0; v < H.num_vertices; ++v) mismatches += result.vertex_labels[v] != reference.vertex_labels[v];
+    for (std::size_t e = 0; e < H.num_hyperedges; ++e) mismatches += result.hyperedge_labels[e] != reference.hyperedge_labels[e];
+    std::cout << "Mismatched labels: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
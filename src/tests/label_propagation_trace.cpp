@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "../base_implementation/headers/algorithms.h"
+#include "../base_implementation/headers/trace.h"
+#include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
+#include <chrono>
+#include <sycl/sycl.hpp>
+
+// Runs one dense variant with tracing on and writes the trace: a .csv path gets the CSV table, any other
+// path a Chrome trace. The labels are compared with an untraced run of the same variant.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [baseline|transpose] [trace.json|trace.csv]" << std::endl;
+        return 1;
+    }
+
+    const std::string variant = argc >= 3 ? argv[2] : "baseline";
+    const std::string path = argc == 4 ? argv[3] : "trace.json";
+    if (variant != "baseline" && variant != "transpose") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
+        return 1;
+    }
+
+    HypergraphNotSparse H = load_hypergraph_dense(argv[1]);
+    HypergraphNotSparse H_untraced = H;
+
+    PropagationTrace trace;
+    std::cout << std::endl << "Traced " << variant << ":" << std::endl;
+    if (variant == "transpose") find_communities_transpose(H, nullptr, &trace);
+    else find_communities(H, nullptr, &trace);
+
+    std::cout << std::endl << "Untraced " << variant << ":" << std::endl;
+    if (variant == "transpose") find_communities_transpose(H_untraced);
+    else find_communities(H_untraced);
+
+    std::cout << std::endl << "sweep  changed hyperedges  changed vertices" << std::endl;
+    for (std::size_t it = 0; it < trace.iterations.size(); ++it) {
+        std::cout << it << "  " << trace.iterations[it].hyperedges << "  " << trace.iterations[it].vertices << std::endl;
+    }
+
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (csv) trace.write_csv(path);
+    else trace.write_chrome_trace(path);
+    std::cout << trace.events.size() << " events written to " << path << std::endl;
+
+    std::size_t mismatches = 0;
+    for (std::size_t v = 0; v < H.num_vertices; ++v) mismatches += H.vertex_labels[v] != H_untraced.vertex_labels[v];
+    for (std::size_t e = 0; e < H.num_hyperedges; ++e) mismatches += H.hyperedge_labels[e] != H_untraced.hyperedge_labels[e];
+    std::cout << "Mismatched labels: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -10,6 +10,7 @@
 #include <string>
 #include "../base_implementation/headers/algorithms.h"
 #include "../base_implementation/headers/utils.h"
+#include "../base_implementation/headers/hypergraph_io.h"
 #include <chrono>
 #include <sycl/sycl.hpp>
 
@@ -18,9 +19,7 @@ HypergraphNotSparse clone_hypergraph(const HypergraphNotSparse& original) {
     copy.num_vertices = original.num_vertices;
     copy.num_hyperedges = original.num_hyperedges;
 
-    copy.incidence_matrix.resize(original.incidence_matrix.size());
-    for (size_t i = 0; i < original.incidence_matrix.size(); ++i)
-        copy.incidence_matrix[i] = original.incidence_matrix[i];
+    copy.incidence_matrix = original.incidence_matrix;
 
     copy.vertex_labels = original.vertex_labels;
     copy.hyperedge_labels = original.hyperedge_labels;
@@ -29,17 +28,14 @@ HypergraphNotSparse clone_hypergraph(const HypergraphNotSparse& original) {
 }
 
 int main(int argc, char** argv) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <num_vertices> <num_hyperedges> <probability>" << std::endl;
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <hypergraph.bin|.hgr|.mtx> [seed_labels.txt]" << std::endl;
         return 1;
     }
 
-    std::size_t num_vertices = std::stoul(argv[1]);
-    std::size_t num_hyperedges = std::stoul(argv[2]);
-    double probability = std::stod(argv[3]);
-
-    // std::cout << "Generating hypergraph..." << std::endl;
-    HypergraphNotSparse H = generate_hypergraph(num_vertices, num_hyperedges, probability);
+    // std::cout << "Loading hypergraph..." << std::endl;
+    HypergraphNotSparse H = load_hypergraph_dense(argv[1]);
+    if (argc == 3) read_seed_labels(argv[2], H.vertex_labels);
     HypergraphNotSparse H_clone = clone_hypergraph(H);
     // std::cout << "Done." << std::endl;
 
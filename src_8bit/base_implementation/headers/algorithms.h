@@ -1,6 +0,0 @@
-#include "utils.h"
-#include <vector>
-#include <cstdint>
-
-void find_communities(HypergraphNotSparse& H);
-void find_communities_transpose(HypergraphNotSparse& H);